@@ -0,0 +1,157 @@
+// fb_damage.cpp
+// Host run of a watt meter layout on linux_framebuffer.h. Drives the
+// widgets through WidgetManager for a number of 20 ms frames, flushing
+// after each, single and then double buffered, and reports how many bytes
+// the damage rects wrote per frame against a full-page copy.
+//
+// Given a regular file (the default) it also reads the shown page back
+// after every flush and exits non-zero if it differs from the canvas.
+// Given /dev/fbN it draws on the real display; that needs a 320x240 mode.
+// Build as for widget_scale.cpp.
+//
+//   fb_damage [framebuffer or file] [frames]
+#ifdef __linux__
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "widget_manager.h"
+#include "linux_framebuffer.h"
+
+const uint16_t COLOR_BG = 0x0000;
+const uint16_t COLOR_FRAME = 0x001F;
+const uint16_t COLOR_TEXT = 0xFFFF;
+const uint16_t COLOR_GRAPH = 0x07E0;
+
+thread_local Adafruit_GFX *gfx = nullptr;
+
+namespace {
+
+constexpr int16_t SCREEN_W = 320;
+constexpr int16_t SCREEN_H = 240;
+constexpr int CHANNELS = 8;
+constexpr int HISTORY_LEN = 50;
+constexpr int16_t TILE_W = SCREEN_W / 2;
+constexpr int16_t TILE_H = 40;
+constexpr int16_t GRAPH_Y = TILE_H * CHANNELS / 2;
+constexpr uint32_t FRAME_MS = 20;
+
+// Readings behind the widgets; channels update at different rates, as
+// the meter's windows and idle circuits make them do
+struct Model {
+  uint32_t now = 0;
+  float watts[CHANNELS] = {};
+  float history[HISTORY_LEN] = {};
+  int historyIndex = 0;
+};
+
+std::vector<Widget *> makeLayout(Model &model) {
+  std::vector<Widget *> widgets;
+  for (int c = 0; c < CHANNELS; c++) {
+    int16_t x = (c % 2) * TILE_W, y = (c / 2) * TILE_H;
+    uint16_t period = c < 2 ? 100 : c < 6 ? 1000 : 10000;
+    widgets.push_back(new Widget(x, y, TILE_W, TILE_H,
+      [&model, c]() { model.watts[c] = roundf(500 + 400 * sinf(model.now * 0.0007f + c)); },
+      [&model, c, x, y]() {
+        char line[24];
+        snprintf(line, sizeof(line), "CH%d %6.0f W", c + 1, model.watts[c]);
+        gfx->setTextColor(COLOR_TEXT, COLOR_BG);
+        gfx->setTextSize(1);
+        gfx->setCursor(x + 4, y + 4);
+        gfx->print(line);
+      }, period));
+  }
+
+  widgets.push_back(new Widget(0, GRAPH_Y, SCREEN_W, SCREEN_H - GRAPH_Y,
+    [&model]() {
+      float total = 0;
+      for (int c = 0; c < CHANNELS; c++) total += model.watts[c];
+      model.history[model.historyIndex] = total;
+      model.historyIndex = (model.historyIndex + 1) % HISTORY_LEN;
+    },
+    [&model]() {
+      const int16_t h = SCREEN_H - GRAPH_Y;
+      gfx->fillRect(0, GRAPH_Y, SCREEN_W, h, COLOR_BG);
+      for (int i = 0; i < HISTORY_LEN; i++) {
+        float watts = model.history[(model.historyIndex + i) % HISTORY_LEN];
+        int16_t y = GRAPH_Y + h - 2 - (int16_t)std::min<float>(h - 3, watts / 100.0f);
+        gfx->drawPixel(4 + i * (SCREEN_W - 8) / HISTORY_LEN, y, COLOR_GRAPH);
+      }
+    }, 1000));
+  widgets.back()->setOpaque(true);
+  return widgets;
+}
+
+// Whether the page the framebuffer file shows matches the canvas
+bool pageMatches(const char *path, LinuxFramebuffer &fb) {
+  const size_t pageBytes = (size_t)SCREEN_W * SCREEN_H * 2;
+  std::vector<uint16_t> page(SCREEN_W * SCREEN_H);
+  FILE *file = fopen(path, "rb");
+  if (!file) return false;
+  bool read = fseek(file, fb.shownPage() * pageBytes, SEEK_SET) == 0 &&
+              fread(page.data(), 1, pageBytes, file) == pageBytes;
+  fclose(file);
+  return read && memcmp(page.data(), fb.getBuffer(), pageBytes) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : "/tmp/fb_damage.raw";
+  int frames = argc > 2 ? atoi(argv[2]) : 500;
+  struct stat st;
+  bool checkFile = stat(path, &st) != 0 || S_ISREG(st.st_mode);
+  if (checkFile) {
+    FILE *file = fopen(path, "wb");
+    if (file) fclose(file);
+  }
+
+  printf("%s, %d frames of %u ms\n", path, frames, FRAME_MS);
+  printf("%-7s %12s %12s %8s %10s %s\n", "pages", "B/frame", "full B", "ratio", "flush us", "pixels");
+
+  bool exact = true;
+  for (bool doubleBuffer : { false, true }) {
+    LinuxFramebuffer fb(SCREEN_W, SCREEN_H);
+    if (!fb.begin(path, doubleBuffer)) {
+      fprintf(stderr, "can't map %s as a %dx%d framebuffer\n", path, SCREEN_W, SCREEN_H);
+      return 1;
+    }
+    gfx = &fb;
+
+    Model model;
+    std::vector<Widget *> layout = makeLayout(model);
+    WidgetManager<LinuxFramebuffer, SCREEN_W, SCREEN_H> manager(fb, layout.data(), layout.size(),
+                                                                layout.data(), layout.size());
+    fb.fillScreen(COLOR_BG);
+    fb.display();
+
+    uint64_t bytesBefore = fb.bytesWritten();
+    double flushUs = 0;
+    bool same = true;
+    for (int f = 0; f < frames; f++) {
+      model.now += FRAME_MS;
+      manager.processAllWidgets(model.now);
+      manager.updateDisplay();
+
+      auto start = std::chrono::steady_clock::now();
+      fb.display();
+      flushUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      if (checkFile && !pageMatches(path, fb)) same = false;
+    }
+    exact &= same;
+
+    double perFrame = (double)(fb.bytesWritten() - bytesBefore) / frames;
+    double full = (double)SCREEN_W * SCREEN_H * 2;
+    printf("%-7d %12.0f %12.0f %7.1f%% %10.1f %s\n", fb.isDoubleBuffered() ? 2 : 1, perFrame, full,
+           100 * perFrame / full, flushUs / frames, !checkFile ? "-" : same ? "same" : "DIFFER");
+
+    for (Widget *w : layout) delete w;
+    fb.end();
+  }
+  return exact ? 0 : 1;
+}
+
+#endif // __linux__
@@ -0,0 +1,234 @@
+// fleet_mirror.cpp
+// Host-only fleet mirror: one copy of the watt meter UI per field unit,
+// each drawing into its own 320x240 canvas through the same widget code
+// the units run, driven by the units' telemetry. A unit is only redrawn
+// when a report changes what it shows, and the redraws of each tick are
+// shared out over a work-stealing thread pool.
+//
+// As a benchmark it replays the same synthetic telemetry at 1, 2, 4, ...
+// threads and reports frames per second and per core. Every run must end
+// with the same pixels in every canvas as the single-threaded one.
+// Build as for widget_scale.cpp, adding -pthread.
+//
+//   fleet_mirror [units] [ticks] [max threads]
+#ifndef ARDUINO
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include "widget_manager.h"
+#include "work_stealing_pool.h"
+
+const uint16_t COLOR_BG = 0x0000;
+const uint16_t COLOR_FRAME = 0x001F;
+const uint16_t COLOR_TEXT = 0xFFFF;
+const uint16_t COLOR_GRAPH = 0x07E0;
+
+thread_local Adafruit_GFX *gfx = nullptr;
+
+namespace {
+
+constexpr int16_t SCREEN_W = 320;
+constexpr int16_t SCREEN_H = 240;
+constexpr int CHANNELS = 8;
+constexpr int HISTORY_LEN = 50;
+constexpr int16_t TILE_W = SCREEN_W / 2;
+constexpr int16_t TILE_H = 40;
+constexpr int16_t GRAPH_Y = TILE_H * CHANNELS / 2;
+constexpr uint32_t TICK_MS = 100;
+
+// One report, as a unit's meter publishes it at the end of a window.
+// Values arrive rounded the way the unit displays them.
+struct Telemetry {
+  float volts;
+  float watts[CHANNELS];
+  float amps[CHANNELS];
+  float wattHours[CHANNELS];
+};
+
+// Deterministic stand-in for one unit's stream. A share of the fleet has
+// no load, so its reports repeat and should cost nothing to mirror.
+class TelemetrySource {
+  public:
+    explicit TelemetrySource(uint32_t unit) : rng(unit), idle(unit % 10 < 3) {
+      for (int c = 0; c < CHANNELS; c++) amps[c] = idle ? 0.0f : loadOf(rng);
+    }
+
+    // False if the unit sent nothing this tick
+    bool next(Telemetry &t) {
+      if (chance(rng) >= 0.6f) return false;
+      if (!idle && chance(rng) < 0.1f) amps[pick(rng)] = loadOf(rng);
+
+      t.volts = roundf(idle ? 230.0f : 220.0f + 10.0f * chance(rng));
+      for (int c = 0; c < CHANNELS; c++) {
+        float watts = t.volts * amps[c] * 0.95f;
+        wattHours[c] += watts * TICK_MS / 3.6e6f;
+        t.watts[c] = roundf(watts);
+        t.amps[c] = roundf(amps[c] * 10) / 10;
+        t.wattHours[c] = roundf(wattHours[c] * 100) / 100;
+      }
+      return true;
+    }
+
+  private:
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> chance{ 0.0f, 1.0f }, loadOf{ 0.5f, 5.0f };
+    std::uniform_int_distribution<int> pick{ 0, CHANNELS - 1 };
+    bool idle;
+    float amps[CHANNELS];
+    float wattHours[CHANNELS] = {};
+};
+
+// The overview layout of one unit: a tile per circuit and a graph of the
+// total load underneath
+class MirrorUnit {
+  public:
+    MirrorUnit()
+      : canvas(SCREEN_W, SCREEN_H), layout(makeWidgets()),
+        manager(canvas, layout.data(), layout.size(), layout.data(), layout.size()) {
+      canvas.fillScreen(COLOR_BG);
+    }
+
+    // Takes a report; true if it changes what the screen shows
+    bool apply(const Telemetry &t) {
+      if (memcmp(&t, &shown, sizeof(t)) == 0) return false;
+      shown = t;
+      float total = 0;
+      for (int c = 0; c < CHANNELS; c++) total += t.watts[c];
+      totalHistory[historyIndex] = total;
+      historyIndex = (historyIndex + 1) % HISTORY_LEN;
+      return true;
+    }
+
+    void render() {
+      gfx = &canvas;
+      manager.updateDisplay();
+    }
+
+    uint64_t checksum() const {
+      const uint16_t *pixels = canvas.getBuffer();
+      uint64_t hash = 1469598103934665603ULL;
+      for (uint32_t i = 0; i < (uint32_t)SCREEN_W * SCREEN_H; i++) hash = (hash ^ pixels[i]) * 1099511628211ULL;
+      return hash;
+    }
+
+  private:
+    Telemetry shown = {};
+    float totalHistory[HISTORY_LEN] = {};
+    int historyIndex = 0;
+    GFXcanvas16 canvas;
+    std::vector<std::unique_ptr<Widget>> owned;
+    std::vector<Widget *> layout;
+    WidgetManager<GFXcanvas16, SCREEN_W, SCREEN_H> manager;
+
+    std::vector<Widget *> makeWidgets() {
+      auto noProcess = []() {};
+
+      for (int c = 0; c < CHANNELS; c++) {
+        int16_t x = (c % 2) * TILE_W, y = (c / 2) * TILE_H;
+        owned.emplace_back(new Widget(x, y, TILE_W, TILE_H, noProcess, [this, c, x, y]() {
+          char line[32];
+          gfx->setTextColor(COLOR_TEXT, COLOR_BG);
+          gfx->setTextSize(1);
+          snprintf(line, sizeof(line), "CH%-2d %6.0f W %5.1f A", c + 1, shown.watts[c], shown.amps[c]);
+          gfx->setCursor(x + 4, y + 4);
+          gfx->print(line);
+          snprintf(line, sizeof(line), "     %8.2f Wh", shown.wattHours[c]);
+          gfx->setCursor(x + 4, y + 16);
+          gfx->print(line);
+        }, 0));
+      }
+
+      owned.emplace_back(new Widget(0, GRAPH_Y, SCREEN_W, SCREEN_H - GRAPH_Y, noProcess, [this]() {
+        const int16_t h = SCREEN_H - GRAPH_Y;
+        gfx->fillRect(0, GRAPH_Y, SCREEN_W, h, COLOR_BG);
+        for (int i = 0; i < HISTORY_LEN; i++) {
+          float watts = totalHistory[(historyIndex + i) % HISTORY_LEN];
+          int16_t y = GRAPH_Y + h - 2 - (int16_t)std::min<float>(h - 3, watts / 100.0f);
+          gfx->drawPixel(4 + i * (SCREEN_W - 8) / HISTORY_LEN, y, COLOR_GRAPH);
+        }
+      }, 0));
+      owned.back()->setOpaque(true);
+
+      std::vector<Widget *> widgets;
+      for (auto &w : owned) widgets.push_back(w.get());
+      return widgets;
+    }
+};
+
+struct Run {
+  unsigned threads;
+  uint64_t frames, skipped;
+  double renderS;
+  uint64_t steals;
+  uint64_t fleetHash;
+};
+
+Run mirror(unsigned units, int ticks, unsigned threads) {
+  std::vector<std::unique_ptr<MirrorUnit>> fleet;
+  std::vector<TelemetrySource> sources;
+  for (unsigned u = 0; u < units; u++) {
+    fleet.emplace_back(new MirrorUnit);
+    sources.emplace_back(u);
+  }
+
+  WorkStealingPool pool(threads);
+  WorkStealingPool::Job render = [&fleet](uint32_t u) { fleet[u]->render(); };
+  Run run = { threads, 0, 0, 0, 0, 0 };
+  std::vector<uint32_t> changed;
+  changed.reserve(units);
+
+  for (int t = 0; t < ticks; t++) {
+    changed.clear();
+    Telemetry report;
+    for (unsigned u = 0; u < units; u++) {
+      if (!sources[u].next(report)) continue;
+      if (fleet[u]->apply(report)) changed.push_back(u);
+      else run.skipped++;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    pool.run(changed, render);
+    run.renderS += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    run.frames += changed.size();
+  }
+
+  run.steals = pool.steals();
+  for (const auto &unit : fleet) run.fleetHash = run.fleetHash * 31 + unit->checksum();
+  return run;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned units = argc > 1 ? atoi(argv[1]) : 1000;
+  int ticks = argc > 2 ? atoi(argv[2]) : 50;
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  // At least two, so the pixel check always compares against a parallel run
+  unsigned maxThreads = argc > 3 ? atoi(argv[3]) : std::max(2u, cores);
+
+  printf("%u units, %d ticks of %u ms, %u cores\n", units, ticks, TICK_MS, cores);
+  printf("%7s %9s %9s %10s %9s %11s %8s %s\n", "threads", "frames", "unchanged", "render ms",
+         "fps", "fps/core", "steals", "pixels");
+
+  bool exact = true;
+  uint64_t reference = 0;
+  for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+    Run r = mirror(units, ticks, threads);
+    if (threads == 1) reference = r.fleetHash;
+    bool same = r.fleetHash == reference;
+    exact &= same;
+    double fps = r.renderS > 0 ? r.frames / r.renderS : 0;
+    printf("%7u %9llu %9llu %10.1f %9.0f %11.0f %8llu %s\n", threads, (unsigned long long)r.frames,
+           (unsigned long long)r.skipped, r.renderS * 1000, fps, fps / std::min(threads, cores),
+           (unsigned long long)r.steals, same ? "same" : "DIFFER");
+  }
+  return exact ? 0 : 1;
+}
+
+#endif // ARDUINO
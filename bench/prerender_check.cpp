@@ -0,0 +1,88 @@
+// prerender_check.cpp
+// Host-only check of the playlist pre-render in widget_manager.h: runs a
+// two-layout playlist through WidgetManager::runPlaylist() until the
+// switch, then compares the frame it presented with the same layout drawn
+// directly. Text sits in every band, including across band edges, since
+// glyphs are what a band-sized clip used to drop. Exits non-zero on any
+// differing pixel. Build as for widget_scale.cpp.
+//
+//   prerender_check
+#ifndef ARDUINO
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "widget_manager.h"
+
+const uint16_t COLOR_BG = 0x0000;
+const uint16_t COLOR_FRAME = 0x001F;
+const uint16_t COLOR_TEXT = 0xFFFF;
+const uint16_t COLOR_BAR = 0x07E0;
+
+thread_local Adafruit_GFX *gfx = nullptr;
+
+namespace {
+
+constexpr int16_t SCREEN_W = 320;
+constexpr int16_t SCREEN_H = 240;
+constexpr uint32_t SHOW_MS = 5000;
+constexpr uint32_t FRAME_MS = 20;
+
+Widget *textWidget(int16_t x, int16_t y, int16_t w, int16_t h, const char *text) {
+  return new Widget(x, y, w, h, []() {}, [x, y, text]() {
+    gfx->setTextColor(COLOR_TEXT, COLOR_BG);
+    gfx->setTextSize(1);
+    gfx->setCursor(x + 4, y + 4);
+    gfx->print(text);
+  }, 1000);
+}
+
+Widget *barWidget(int16_t x, int16_t y, int16_t w, int16_t h) {
+  return new Widget(x, y, w, h, []() {}, [x, y, w, h]() {
+    gfx->fillRect(x + 2, y + 2, (w - 4) * 2 / 3, h - 4, COLOR_BAR);
+  }, 1000);
+}
+
+}  // namespace
+
+int main() {
+  GFXcanvas16 panel(SCREEN_W, SCREEN_H), reference(SCREEN_W, SCREEN_H);
+
+  // Rows every 36 px, so tiles start inside bands and cross their edges
+  std::vector<Widget *> first = { textWidget(10, 10, 120, 30, "Watts") };
+  std::vector<Widget *> second;
+  for (int16_t y = 0; y + 30 <= SCREEN_H; y += 36) {
+    second.push_back(textWidget(0, y, 150, 30, "Volts 231.0"));
+    second.push_back(y % 72 ? barWidget(160, y, 150, 30) : textWidget(160, y, 150, 30, "Amperes 4.2"));
+  }
+
+  gfx = &panel;
+  panel.fillScreen(COLOR_BG);
+  WidgetManager<GFXcanvas16, SCREEN_W, SCREEN_H> manager(panel, first.data(), first.size(),
+                                                         first.data(), first.size());
+  LayoutPlaylist<Widget> playlist;
+  playlist.add(first.data(), first.size(), SHOW_MS);
+  playlist.add(second.data(), second.size(), SHOW_MS);
+  playlist.begin(0);
+  for (uint32_t now = 0; now <= SHOW_MS; now += FRAME_MS) manager.runPlaylist(playlist, now);
+
+  gfx = &reference;
+  reference.fillScreen(COLOR_BG);
+  WidgetManager<GFXcanvas16, SCREEN_W, SCREEN_H> direct(reference, second.data(), second.size(),
+                                                        second.data(), second.size());
+  direct.updateDisplay();
+
+  uint32_t differing = 0, lit = 0;
+  for (uint32_t i = 0; i < (uint32_t)SCREEN_W * SCREEN_H; i++) {
+    if (panel.getBuffer()[i] != reference.getBuffer()[i]) differing++;
+    if (reference.getBuffer()[i] == COLOR_TEXT) lit++;
+  }
+  printf("%u of %u pixels differ (%u text pixels in the layout)\n", differing,
+         (unsigned)SCREEN_W * SCREEN_H, lit);
+
+  for (Widget *w : first) delete w;
+  for (Widget *w : second) delete w;
+  return differing == 0 && lit > 0 ? 0 : 1;
+}
+
+#endif // ARDUINO
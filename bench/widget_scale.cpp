@@ -0,0 +1,380 @@
+// widget_scale.cpp
+// Host-only scalability benchmark for widget_manager.h. Generates layouts
+// of mixed widgets (text, bars, graphs, frames) at growing counts, runs
+// them through WidgetManager into a 320x240 RGB565 canvas and reports, per
+// widget count:
+//   build    building the draw list (construction or a layout switch)
+//   process  processAllWidgets() per frame
+//   draw     updateDisplay() per frame
+//   flush    SPI time the frame's drawing would take on an ILI9341 at 40 MHz
+//   heap     bytes allocated for the widgets and the manager
+// then builds a refactor3 Screen with the same number of focusable
+// widgets on the same grid and reports
+//   screen   Screen::draw() with every widget dirty, as after a switch
+//   focus    a DOWN press per widget, once round the screen, each
+//            followed by the draw() that shows it
+// and the growth exponent of each over the upper half of the range, so
+// O(n) and O(n^2) paths stand out.
+//
+// Builds against the Adafruit_GFX sources and a host Arduino.h (Print,
+// min/max), from the repository root: compile bench/widget_scale.cpp with
+// -I. and both include paths, and link Adafruit_GFX.cpp and Print.cpp.
+// The Screen side also needs new1/examples/dt_charger/refactor3 split out
+// as its replay.cpp describes, with that directory on the include path.
+//
+//   widget_scale [max widgets] [frames]
+#ifndef ARDUINO
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+#include "widget_manager.h"
+
+// refactor3's Widget shares this one's name and constructor, so its
+// Widget and Screen are compiled in here, inside a namespace, instead of
+// being linked. Its screen.h guard takes the name SCREEN_H.
+namespace screen_ui {
+#include "ui_components.h"
+#include "screen.h"
+#include "ui_components.cpp"
+#include "screen.cpp"
+}  // namespace screen_ui
+
+const uint16_t COLOR_BG = 0x0000;
+const uint16_t COLOR_FRAME = 0x001F;
+const uint16_t COLOR_TEXT = 0xFFFF;
+const uint16_t COLOR_GRAPH = 0x07E0;
+
+thread_local Adafruit_GFX *gfx = nullptr;
+
+namespace {
+
+constexpr int16_t PANEL_W = 320;
+constexpr int16_t PANEL_H = 240;
+constexpr double SPI_HZ = 40e6;
+constexpr uint32_t WINDOW_BYTES = 11;       // CASET, RASET, RAMWR with their arguments
+constexpr uint32_t FRAME_MS = 20;
+constexpr double SUPERLINEAR = 1.5;         // Exponent that gets a phase flagged
+
+std::atomic<uint64_t> heapUsed{ 0 };
+
+}  // namespace
+
+// Counts what malloc actually hands out, so new and delete agree on a
+// block's size without storing it. Kept out of line: inlined into a
+// caller, GCC sees free() on a pointer from new and warns
+__attribute__((noinline)) void *operator new(size_t size) {
+  void *p = malloc(size);
+  if (!p) throw std::bad_alloc();
+  heapUsed += malloc_usable_size(p);
+  return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept {
+  if (!p) return;
+  heapUsed -= malloc_usable_size(p);
+  free(p);
+}
+
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+
+namespace {
+
+// Canvas that also counts what drawing straight to the panel would send:
+// one address window per primitive plus two bytes per pixel
+class CountingPanel : public GFXcanvas16 {
+  public:
+    CountingPanel() : GFXcanvas16(PANEL_W, PANEL_H) {}
+
+    uint64_t spiBytes = 0;
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+      count(1);
+      GFXcanvas16::drawPixel(x, y, color);
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+      count(w);
+      GFXcanvas16::drawFastHLine(x, y, w, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+      count(h);
+      GFXcanvas16::drawFastVLine(x, y, h, color);
+    }
+
+    // The panel fills a rect through one window; the canvas does it by lines
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+      count((uint32_t)w * h);
+      nested++;
+      GFXcanvas16::fillRect(x, y, w, h, color);
+      nested--;
+    }
+
+  private:
+    int nested = 0;
+
+    void count(uint32_t pixels) {
+      if (!nested) spiBytes += WINDOW_BYTES + 2 * pixels;
+    }
+};
+
+enum class Kind { TEXT, BAR, GRAPH, FRAME };
+
+constexpr uint16_t FREQUENCIES_MS[] = { 20, 100, 250, 1000, 5000 };
+constexpr int GRAPH_POINTS = 32;
+
+// State behind the generated widgets' callbacks, one slot per widget
+struct Model {
+  std::vector<float> value;
+  std::vector<std::vector<float>> history;
+  uint32_t now = 0;
+};
+
+// Grid sized for a widget count, roughly square cells over the screen
+struct Grid {
+  int columns, rows;
+  int16_t cellW, cellH;
+
+  explicit Grid(int count)
+      : columns(std::max(1, (int)std::ceil(std::sqrt(count * (float)PANEL_W / PANEL_H)))),
+        rows(std::max(1, (count + columns - 1) / columns)),
+        cellW(std::max(8, PANEL_W / columns)), cellH(std::max(8, PANEL_H / rows)) {}
+
+  int16_t x(int i) const { return (i % columns) * PANEL_W / columns; }
+  int16_t y(int i) const { return (i / columns) * PANEL_H / rows; }
+};
+
+// Widgets are spread over a grid sized for the count, each spanning one
+// to two cells, so they get smaller and overlap more as the count grows
+std::vector<Widget *> generate(int count, Model &model, std::mt19937 &rng) {
+  std::vector<Widget *> widgets;
+  model.value.assign(count, 0.0f);
+  model.history.assign(count, std::vector<float>());
+
+  Grid grid(count);
+  std::uniform_int_distribution<int> kindOf(0, 9), span(1, 2), zOf(0, 3), freqOf(0, 4);
+
+  for (int i = 0; i < count; i++) {
+    int16_t x = grid.x(i), y = grid.y(i);
+    int16_t w = std::min<int16_t>(grid.cellW * span(rng), PANEL_W - x);
+    int16_t h = std::min<int16_t>(grid.cellH * span(rng), PANEL_H - y);
+    int k = kindOf(rng);
+    Kind kind = k < 4 ? Kind::TEXT : k < 7 ? Kind::BAR : k < 8 ? Kind::GRAPH : Kind::FRAME;
+
+    float *value = &model.value[i];
+    std::vector<float> *history = &model.history[i];
+    uint32_t *now = &model.now;
+    std::function<void()> process = [value, now, i]() {
+      *value = 0.5f + 0.5f * sinf(*now * 0.001f + i);
+    };
+    std::function<void()> display = []() {};
+
+    switch (kind) {
+      case Kind::TEXT:
+        display = [value, x, y]() {
+          char line[12];
+          snprintf(line, sizeof(line), "%6.2f", *value * 100);
+          gfx->setTextColor(COLOR_TEXT, COLOR_BG);
+          gfx->setTextSize(1);
+          gfx->setCursor(x + 2, y + 2);
+          gfx->print(line);
+        };
+        break;
+      case Kind::BAR:
+        display = [value, x, y, w, h]() {
+          int16_t filled = (int16_t)(*value * (w - 4));
+          gfx->fillRect(x + 2, y + 2, filled, h - 4, COLOR_GRAPH);
+          gfx->fillRect(x + 2 + filled, y + 2, w - 4 - filled, h - 4, COLOR_BG);
+        };
+        break;
+      case Kind::GRAPH:
+        process = [value, history, now, i]() {
+          *value = 0.5f + 0.5f * sinf(*now * 0.001f + i);
+          if (history->size() == GRAPH_POINTS) history->erase(history->begin());
+          history->push_back(*value);
+        };
+        display = [history, x, y, w, h]() {
+          gfx->fillRect(x, y, w, h, COLOR_BG);
+          for (size_t p = 0; p < history->size(); p++) {
+            gfx->drawPixel(x + p * w / GRAPH_POINTS, y + h - 1 - (int16_t)((*history)[p] * (h - 1)), COLOR_GRAPH);
+          }
+        };
+        break;
+      case Kind::FRAME:
+        break;
+    }
+
+    Widget *widget = new Widget(x, y, w, h, process, display, FREQUENCIES_MS[freqOf(rng)]);
+    widget->setZOrder(zOf(rng)).setOpaque(kind == Kind::GRAPH);
+    widgets.push_back(widget);
+  }
+  return widgets;
+}
+
+// One grid cell on a generated Screen, drawn the way refactor3's Button
+// shows focus: filled when focused, outlined otherwise
+class Cell : public screen_ui::Widget {
+  public:
+    Cell(int16_t x, int16_t y, int16_t w, int16_t h, int index) : Widget(x, y, w, h), index(index) {}
+
+    void draw(Adafruit_GFX &display) override {
+      display.fillRect(x, y, width, height, focused ? COLOR_TEXT : COLOR_BG);
+      display.drawRect(x, y, width, height, COLOR_FRAME);
+      display.setTextColor(focused ? COLOR_BG : COLOR_TEXT);
+      display.setCursor(x + 2, y + 2);
+      display.print(index);
+    }
+
+    void handleInput(const screen_ui::IRCommand &) override {}
+    void update() override {}
+
+  private:
+    int index;
+};
+
+class GeneratedScreen : public screen_ui::Screen {
+  public:
+    explicit GeneratedScreen(int count) {
+      Grid grid(count);
+      for (int i = 0; i < count; i++) addWidget<Cell>(grid.x(i), grid.y(i), grid.cellW, grid.cellH, i);
+    }
+
+    // What a screen switch leaves: everything to draw
+    void invalidate() {
+      for (auto &widget : widgets) widget->markDirty();
+    }
+};
+
+struct Row {
+  int widgets;
+  double buildUs, processUs, drawUs, flushMs;
+  uint64_t heapBytes;
+  double screenDrawUs, focusSweepUs;
+};
+
+double elapsedUs(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - since).count();
+}
+
+void measureScreen(int count, int frames, Row &row) {
+  CountingPanel panel;
+  GeneratedScreen screen(count);
+
+  double drawUs = 0;
+  for (int f = 0; f < frames; f++) {
+    screen.invalidate();
+    auto start = std::chrono::steady_clock::now();
+    screen.draw(panel);
+    drawUs += elapsedUs(start);
+  }
+
+  const screen_ui::IRCommand down = { screen_ui::IRCodes::DOWN, nullptr, "Down" };
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < count; i++) {
+    screen.handleInput(down);
+    screen.draw(panel);
+  }
+  row.focusSweepUs = elapsedUs(start);
+  row.screenDrawUs = drawUs / frames;
+}
+
+Row measure(int count, int frames) {
+  typedef WidgetManager<CountingPanel, PANEL_W, PANEL_H> Manager;
+  CountingPanel panel;
+  gfx = &panel;
+  std::mt19937 rng(count);
+  Model model;
+
+  uint64_t heapBefore = heapUsed;
+  std::vector<Widget *> widgets = generate(count, model, rng);
+
+  auto start = std::chrono::steady_clock::now();
+  Manager *manager = new Manager(panel, widgets.data(), count, widgets.data(), count);
+  double buildUs = elapsedUs(start);
+  uint64_t heapBytes = heapUsed - heapBefore;
+
+  // A switch rebuilds the same list; time it too and keep the worse
+  start = std::chrono::steady_clock::now();
+  manager->switchLayout(widgets.data(), count);
+  buildUs = std::max(buildUs, elapsedUs(start));
+
+  double processUs = 0, drawUs = 0;
+  panel.spiBytes = 0;
+  for (int f = 0; f < frames; f++) {
+    model.now += FRAME_MS;
+
+    start = std::chrono::steady_clock::now();
+    manager->processAllWidgets(model.now);
+    processUs += elapsedUs(start);
+
+    start = std::chrono::steady_clock::now();
+    manager->updateDisplay();
+    drawUs += elapsedUs(start);
+  }
+
+  Row row = { count, buildUs, processUs / frames, drawUs / frames,
+              panel.spiBytes * 8.0 / SPI_HZ * 1000.0 / frames, heapBytes, 0, 0 };
+
+  delete manager;
+  for (Widget *w : widgets) delete w;
+  measureScreen(count, frames, row);
+  return row;
+}
+
+// Growth exponent between two rows: 1 is linear, 2 quadratic
+double exponent(double a, double b, int na, int nb) {
+  if (a <= 0 || b <= 0) return 0;
+  return std::log(b / a) / std::log((double)nb / na);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int maxWidgets = argc > 1 ? atoi(argv[1]) : 4096;
+  int frames = argc > 2 ? atoi(argv[2]) : 50;
+  // Counts double from 8, and the growth exponents need two of them
+  if (maxWidgets < 16 || frames < 1) {
+    fprintf(stderr, "usage: widget_scale [max widgets >= 16] [frames >= 1]\n");
+    return 1;
+  }
+
+  std::vector<Row> rows;
+  for (int n = 8; n <= maxWidgets; n *= 2) rows.push_back(measure(n, frames));
+
+  printf("%7s %11s %11s %11s %10s %9s %7s %11s %11s\n", "widgets", "build us", "process us", "draw us",
+         "flush ms", "heap B", "B/wdgt", "screen us", "focus us");
+  for (const Row &r : rows) {
+    printf("%7d %11.1f %11.1f %11.1f %10.2f %9llu %7llu %11.1f %11.1f\n", r.widgets, r.buildUs, r.processUs,
+           r.drawUs, r.flushMs, (unsigned long long)r.heapBytes, (unsigned long long)(r.heapBytes / r.widgets),
+           r.screenDrawUs, r.focusSweepUs);
+  }
+
+  // Exponents over the larger half of the range, where fixed costs no
+  // longer dominate
+  const Row &a = rows[(rows.size() - 1) / 2], &b = rows.back();
+  struct Phase { const char *name; double from, to; } phases[] = {
+    { "build", a.buildUs, b.buildUs },
+    { "process", a.processUs, b.processUs },
+    { "draw", a.drawUs, b.drawUs },
+    { "flush", a.flushMs, b.flushMs },
+    { "heap", (double)a.heapBytes, (double)b.heapBytes },
+    { "screen", a.screenDrawUs, b.screenDrawUs },
+    { "focus", a.focusSweepUs, b.focusSweepUs },
+  };
+  printf("growth %d -> %d widgets:\n", a.widgets, b.widgets);
+  for (const Phase &p : phases) {
+    double k = exponent(p.from, p.to, a.widgets, b.widgets);
+    printf("  %-8s n^%.2f%s\n", p.name, k, k > SUPERLINEAR ? "  superlinear" : "");
+  }
+  return 0;
+}
+
+#endif // ARDUINO
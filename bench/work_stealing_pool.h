@@ -0,0 +1,128 @@
+// work_stealing_pool.h
+// Fixed set of worker threads that share batches of indexed jobs
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Each batch is dealt out in contiguous runs, one deque per worker. A
+// worker takes from the back of its own deque, so it stays on items next
+// to the last one it touched, and when that runs dry it steals from the
+// front of the others'. Uneven jobs (a unit whose whole screen changed
+// next to one with a single new number) then even out without a shared
+// queue every worker contends on.
+class WorkStealingPool {
+  public:
+    typedef std::function<void(uint32_t)> Job;
+
+    explicit WorkStealingPool(unsigned threads) {
+      if (threads == 0) threads = 1;
+      for (unsigned i = 0; i < threads; i++) queues.emplace_back(new Queue);
+      for (unsigned i = 0; i < threads; i++) workers.emplace_back([this, i]() { work(i); });
+    }
+
+    ~WorkStealingPool() {
+      {
+        std::lock_guard<std::mutex> guard(state);
+        stopping = true;
+      }
+      wake.notify_all();
+      for (std::thread &t : workers) t.join();
+    }
+
+    // Runs job(item) for every item and returns once all have finished
+    void run(const std::vector<uint32_t> &items, const Job &job) {
+      if (items.empty()) return;
+
+      std::unique_lock<std::mutex> lock(state);
+      current = &job;
+      remaining = items.size();
+      size_t per = (items.size() + queues.size() - 1) / queues.size();
+      for (size_t q = 0; q < queues.size(); q++) {
+        std::lock_guard<std::mutex> guard(queues[q]->lock);
+        for (size_t i = q * per; i < std::min(items.size(), (q + 1) * per); i++) {
+          queues[q]->items.push_back(items[i]);
+        }
+      }
+      generation++;
+      wake.notify_all();
+      done.wait(lock, [this]() { return remaining.load() == 0; });
+      current = nullptr;
+    }
+
+    unsigned size() const { return workers.size(); }
+    uint64_t steals() const { return stolen.load(); }
+
+  private:
+    struct Queue {
+      std::mutex lock;
+      std::deque<uint32_t> items;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex state;
+    std::condition_variable wake, done;
+    std::atomic<const Job *> current{ nullptr };
+    uint64_t generation = 0;
+    bool stopping = false;
+    std::atomic<size_t> remaining{ 0 };
+    std::atomic<uint64_t> stolen{ 0 };
+
+    bool take(unsigned self, uint32_t &item) {
+      {
+        Queue &own = *queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.items.empty()) {
+          item = own.items.back();
+          own.items.pop_back();
+          return true;
+        }
+      }
+      for (size_t k = 1; k < queues.size(); k++) {
+        Queue &victim = *queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.items.empty()) {
+          item = victim.items.front();
+          victim.items.pop_front();
+          stolen++;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void work(unsigned self) {
+      uint64_t seen = 0;
+      for (;;) {
+        {
+          std::unique_lock<std::mutex> lock(state);
+          wake.wait(lock, [&]() { return stopping || generation != seen; });
+          if (stopping) return;
+          seen = generation;
+        }
+
+        // Items only exist while run() holds its job, and a worker still
+        // draining may pick up the next batch, so the job is read per item
+        uint32_t item;
+        while (take(self, item)) {
+          (*current.load())(item);
+          if (remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> guard(state);
+            done.notify_all();
+          }
+        }
+      }
+    }
+};
+
+#endif // WORK_STEALING_POOL_H
@@ -0,0 +1,94 @@
+// channel_meter.h
+// Metering core for several circuits sharing one voltage reference
+
+#ifndef CHANNEL_METER_H
+#define CHANNEL_METER_H
+
+#include <Arduino.h>
+#include <math.h>
+
+// Accumulates sample batches for CHANNELS circuits and turns them into
+// RMS, power and energy readings once per window.
+//
+// Every per-channel quantity is its own array indexed by channel, rather
+// than one struct per channel: the batch loop then walks contiguous
+// floats, each channel's sums stay in registers for the whole batch, and
+// widgets read a single field across channels without striding.
+template <uint8_t CHANNELS>
+class ChannelMeter {
+  public:
+    // Readings from the last closed window
+    float volts = 0;                    // RMS, shared by all channels
+    float amps[CHANNELS] = {};          // RMS
+    float watts[CHANNELS] = {};         // Real (mean of v * i)
+    float peakWatts[CHANNELS] = {};     // Highest window power
+    float peakAmps[CHANNELS] = {};      // Highest instantaneous |i|
+    float wattHours[CHANNELS] = {};
+
+    // Adds n simultaneous samples: voltage[k], and the current of channel c
+    // at currents[c * n + k]
+    void addBatch(const float *voltage, const float *currents, uint16_t n) {
+      float v2 = 0;
+      for (uint16_t k = 0; k < n; k++) {
+        v2 += voltage[k] * voltage[k];
+      }
+      sumV2 += v2;
+
+      for (uint8_t c = 0; c < CHANNELS; c++) {
+        const float *i = currents + (uint32_t)c * n;
+        float i2 = 0, p = 0, peak = peakAmps[c];
+        for (uint16_t k = 0; k < n; k++) {
+          i2 += i[k] * i[k];
+          p += voltage[k] * i[k];
+          peak = max(peak, fabsf(i[k]));
+        }
+        sumI2[c] += i2;
+        sumP[c] += p;
+        peakAmps[c] = peak;
+      }
+      sampleCount += n;
+    }
+
+    // Publishes the readings for everything added since the last call and
+    // integrates energy over the window length
+    void closeWindow(uint32_t elapsedMs) {
+      if (sampleCount == 0) return;
+
+      float scale = 1.0f / sampleCount;
+      float hours = elapsedMs * MS_TO_HOURS;
+      volts = sqrtf(sumV2 * scale);
+      for (uint8_t c = 0; c < CHANNELS; c++) {
+        amps[c] = sqrtf(sumI2[c] * scale);
+        watts[c] = sumP[c] * scale;
+        peakWatts[c] = max(peakWatts[c], watts[c]);
+        wattHours[c] += watts[c] * hours;
+        sumI2[c] = 0;
+        sumP[c] = 0;
+      }
+      sumV2 = 0;
+      sampleCount = 0;
+    }
+
+    float totalWatts() const {
+      float total = 0;
+      for (uint8_t c = 0; c < CHANNELS; c++) total += watts[c];
+      return total;
+    }
+
+    void resetPeaks() {
+      for (uint8_t c = 0; c < CHANNELS; c++) {
+        peakWatts[c] = 0;
+        peakAmps[c] = 0;
+      }
+    }
+
+  private:
+    static constexpr float MS_TO_HOURS = 1.0f / (60 * 60 * 1000);
+
+    float sumV2 = 0;
+    float sumI2[CHANNELS] = {};
+    float sumP[CHANNELS] = {};
+    uint32_t sampleCount = 0;
+};
+
+#endif // CHANNEL_METER_H
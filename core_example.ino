@@ -1,6 +1,7 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_ILI9341.h>  // Example: For TFT display
 #include <SPI.h>
+#include "struct_widget.h"
 
 // Define global constants for the display
 #define TFT_CS     15
@@ -13,48 +14,38 @@ const uint16_t COLOR_BG = ILI9341_BLACK;
 const uint16_t COLOR_TEXT = ILI9341_WHITE;
 const uint16_t COLOR_FRAME = ILI9341_BLUE;
 
-// Callback function types for widgets
-typedef void (*ProcessCallback)(void *);
-typedef void (*DisplayCallback)(void *);
-
-// Define the Widget structure
-struct Widget {
-  int16_t x, y, width, height;  // Position and size
-  ProcessCallback processCb;    // Process callback (logic)
-  DisplayCallback displayCb;    // Display callback (rendering)
-  uint16_t processFrequency;    // Frequency for process update
-  uint32_t lastProcessTime;     // Last time process callback ran
-  bool hasFrame;                // Whether to draw a frame
-  bool hasBackground;           // Whether to fill a background
-  uint16_t bgColor;             // Background color
+// Example per-instance data for a widget type (e.g., voltage display)
+struct VoltageReading {
+  int millivolts;
 };
 
-// Example of process and display callback for a widget (e.g., voltage display)
-void processVoltage(void *data) {
+// Example of process and display callback for a widget
+void processVoltage(VoltageReading &reading) {
   // Simulate dynamic voltage reading (replace with actual logic)
-  int *voltage = (int *)data;
-  *voltage = random(0, 500);  // Simulating 0-5V in mV
+  reading.millivolts = random(0, 500);  // Simulating 0-5V in mV
 }
 
-void displayVoltage(void *data) {
-  int *voltage = (int *)data;
+void displayVoltage(const Widget &widget, VoltageReading &reading) {
   char voltageStr[10];
-  sprintf(voltageStr, "%d mV", *voltage);
+  sprintf(voltageStr, "%d mV", reading.millivolts);
   
-  tft.setCursor(10, 10);
+  tft.setCursor(widget.x, widget.y);
   tft.setTextColor(COLOR_TEXT);
   tft.setTextSize(2);
   tft.print(voltageStr);
 }
 
-// Define widgets statically
-int voltageData = 0;  // Example dynamic data for voltage
-Widget voltageWidget = {
-  10, 10, 100, 50, processVoltage, displayVoltage, 1000, 0, true, true, ILI9341_RED
+// Define widgets statically. Contexts of one type sit together in an
+// array, so widgets of that type walk contiguous memory.
+#define VOLTAGE_INPUTS 2
+VoltageReading voltageReadings[VOLTAGE_INPUTS];
+Widget voltageWidgets[VOLTAGE_INPUTS] = {
+  makeWidget<VoltageReading, processVoltage, displayVoltage>(voltageReadings[0], 10, 10, 100, 50, 1000, true, true, ILI9341_RED),
+  makeWidget<VoltageReading, processVoltage, displayVoltage>(voltageReadings[1], 10, 70, 100, 50, 1000, true, true, ILI9341_RED)
 };
 
 // Multiple widget sets (layouts)
-Widget *layout1[] = { &voltageWidget };
+Widget *layout1[] = { &voltageWidgets[0], &voltageWidgets[1] };
 
 // Current layout pointer
 Widget **currentLayout = layout1;
@@ -65,7 +56,9 @@ void setup() {
   tft.fillScreen(COLOR_BG);
   
   // Set initial data
-  voltageWidget.processCb(&voltageData);
+  for (int i = 0; i < VOLTAGE_INPUTS; i++) {
+    voltageWidgets[i].processCb(voltageWidgets[i]);
+  }
 }
 
 void loop() {
@@ -77,7 +70,7 @@ void loop() {
     
     // Process logic based on frequency
     if (currentTime - widget->lastProcessTime >= widget->processFrequency) {
-      widget->processCb(&voltageData);
+      widget->processCb(*widget);
       widget->lastProcessTime = currentTime;
     }
 
@@ -87,7 +80,7 @@ void loop() {
     }
 
     // Call the display callback to render the widget
-    widget->displayCb(&voltageData);
+    widget->displayCb(*widget);
 
     // Draw a frame around the widget if enabled
     if (widget->hasFrame) {
@@ -0,0 +1,198 @@
+// layout_playlist.h
+// Timed layout rotation with off-screen pre-rendering of the next layout
+
+#ifndef LAYOUT_PLAYLIST_H
+#define LAYOUT_PLAYLIST_H
+
+#include <Adafruit_GFX.h>
+#include <vector>
+#include <functional>
+
+// Start pre-rendering the next layout this long before it is due
+#define PRERENDER_LEAD_MS 2000
+
+// Height of one off-screen band (a 320 px wide band is 2 bytes * 320 * 40 = 25 KB)
+#define PRERENDER_BAND_HEIGHT 40
+
+// Ordered list of layouts, each shown for its own duration, looping
+template <typename WidgetT>
+class LayoutPlaylist {
+public:
+    struct Entry {
+        WidgetT **widgets;
+        int count;
+        uint32_t durationMs;
+    };
+
+    void add(WidgetT **widgets, int count, uint32_t durationMs) {
+        entries.push_back({ widgets, count, durationMs });
+    }
+
+    void begin(uint32_t now) {
+        index = 0;
+        shownSince = now;
+    }
+
+    const Entry &current() const { return entries[index]; }
+    const Entry &upcoming() const { return entries[(index + 1) % entries.size()]; }
+
+    int32_t msUntilSwitch(uint32_t now) const {
+        return (int32_t)(shownSince + current().durationMs - now);
+    }
+
+    // Moves on to the next layout once the current one has had its time
+    bool advance(uint32_t now) {
+        if (entries.size() < 2 || msUntilSwitch(now) > 0) return false;
+        index = (index + 1) % entries.size();
+        shownSince = now;
+        return true;
+    }
+
+private:
+    std::vector<Entry> entries;
+    size_t index = 0;
+    uint32_t shownSince = 0;
+};
+
+// 16-bit canvas holding one horizontal band of the screen. Drawing calls
+// take screen coordinates; anything outside the band is clipped.
+class BandCanvas : public GFXcanvas16 {
+public:
+    // GFX's own clipping (drawChar gives up on y >= height()) works in
+    // screen coordinates before fill() sees them, so it gets the screen's
+    // height; clipping to the band is left to fill()
+    BandCanvas(uint16_t w, uint16_t bandHeight, uint16_t screenHeight)
+        : GFXcanvas16(w, bandHeight), top(0) {
+        _width = w;
+        _height = screenHeight;
+    }
+
+    void setTop(int16_t y) { top = y; }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        fill(x, y, 1, 1, color);
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+        fill(x, y, w, 1, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+        fill(x, y, 1, h, color);
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+        fill(x, y, w, h, color);
+    }
+
+    void fillScreen(uint16_t color) override {
+        std::fill(getBuffer(), getBuffer() + WIDTH * HEIGHT, color);
+    }
+
+private:
+    int16_t top;
+
+    void fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        y -= top;
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > WIDTH) w = WIDTH - x;
+        if (y + h > HEIGHT) h = HEIGHT - y;
+        if (w <= 0 || h <= 0) return;
+
+        uint16_t *row = getBuffer() + y * WIDTH + x;
+        for (int16_t j = 0; j < h; j++, row += WIDTH) {
+            std::fill(row, row + w, color);
+        }
+    }
+};
+
+// Off-screen copy of a full frame. It is rendered one band per step, so the
+// work can be spread over slack time, and each band is kept run-length
+// encoded: UI frames are mostly flat background, so a whole frame costs a
+// few KB instead of the 150 KB of a raw 320x240 buffer.
+class PrerenderedFrame {
+public:
+    typedef std::function<void(Adafruit_GFX &)> RenderFn;
+
+    PrerenderedFrame(int16_t w, int16_t h, int16_t bandHeight = PRERENDER_BAND_HEIGHT)
+        : width(w), height(h), bandHeight(bandHeight), canvas(w, bandHeight, h),
+          bandCount((h + bandHeight - 1) / bandHeight), nextBand(-1), background(0) {}
+
+    // False if the band buffer couldn't be allocated
+    bool available() const { return canvas.getBuffer() != nullptr; }
+
+    bool isStarted() const { return nextBand >= 0; }
+    bool isComplete() const { return nextBand >= bandCount; }
+
+    void start(uint16_t bgColor, RenderFn fn) {
+        render = fn;
+        background = bgColor;
+        bands.assign(bandCount, std::vector<uint16_t>());
+        nextBand = 0;
+    }
+
+    void discard() {
+        nextBand = -1;
+        bands.clear();
+    }
+
+    // Renders the next band; returns true once the whole frame is done
+    bool renderStep() {
+        if (!available() || !isStarted() || isComplete()) return isComplete();
+
+        canvas.setTop(nextBand * bandHeight);
+        canvas.fillScreen(background);
+        render(canvas);
+        encode(bands[nextBand], rowsIn(nextBand));
+        nextBand++;
+        return isComplete();
+    }
+
+    // Sends the frame band by band: push(y, pixels, width, rows)
+    template <typename PushFn>
+    void present(PushFn push) {
+        for (int16_t b = 0; b < bandCount; b++) {
+            decode(bands[b]);
+            push(b * bandHeight, canvas.getBuffer(), width, rowsIn(b));
+        }
+        discard();
+    }
+
+private:
+    int16_t width, height, bandHeight;
+    BandCanvas canvas;
+    int16_t bandCount;
+    int16_t nextBand;      // -1 when idle
+    uint16_t background;
+    RenderFn render;
+    std::vector<std::vector<uint16_t>> bands;   // (run length, color) pairs
+
+    int16_t rowsIn(int16_t band) const {
+        return min<int16_t>(bandHeight, height - band * bandHeight);
+    }
+
+    void encode(std::vector<uint16_t> &out, int16_t rows) {
+        const uint16_t *pixels = canvas.getBuffer();
+        uint32_t total = (uint32_t)width * rows;
+        out.clear();
+        for (uint32_t i = 0; i < total;) {
+            uint16_t color = pixels[i];
+            uint16_t run = 1;
+            while (i + run < total && pixels[i + run] == color && run < 0xFFFF) run++;
+            out.push_back(run);
+            out.push_back(color);
+            i += run;
+        }
+        out.shrink_to_fit();
+    }
+
+    void decode(const std::vector<uint16_t> &in) {
+        uint16_t *pixels = canvas.getBuffer();
+        for (size_t i = 0; i + 1 < in.size(); i += 2) {
+            pixels = std::fill_n(pixels, in[i], in[i + 1]);
+        }
+    }
+};
+
+#endif // LAYOUT_PLAYLIST_H
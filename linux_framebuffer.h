@@ -0,0 +1,356 @@
+// linux_framebuffer.h
+// Adafruit_GFX display on a Linux framebuffer device (/dev/fbN), for
+// running the widget UI on single-board computers with SPI TFTs
+
+#ifndef LINUX_FRAMEBUFFER_H
+#define LINUX_FRAMEBUFFER_H
+
+#ifdef __linux__
+
+#include <Adafruit_GFX.h>
+#include <fcntl.h>
+#include <linux/fb.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string.h>
+#include <vector>
+
+// Damage rects closer than this are merged into one
+#define FB_DAMAGE_MERGE_GAP 8
+
+// Damage rects kept per frame; past this a new one joins the rect it
+// grows least
+#define FB_MAX_DAMAGE_RECTS 16
+
+// Drawing goes to an RGB565 canvas in RAM, and display() copies what
+// changed since the last call into the mapped framebuffer. Only pixels
+// that change value count as damage, and within a damaged rect each row
+// is compared with a copy of what that page already holds, so widgets
+// that repaint the same text, or clear and redraw an unchanged graph,
+// cost nothing to flush. On fbtft drivers every written page goes out
+// over SPI again, which makes this matter.
+//
+// With double buffering the framebuffer's virtual height holds two
+// pages: display() writes the hidden one and pans to it, so a frame is
+// never seen half written. The hidden page is a frame behind, so the
+// previous frame's damage is written to it again along with the new one.
+//
+// A regular file can stand in for the device. It is treated as RGB565
+// pages of the constructor's size, stacked, so the output can be checked
+// on any Linux machine.
+//
+// Screens written for the SSD1306 draw in WHITE and BLACK (1 and 0);
+// setMonochrome() turns those into real colours at flush time.
+class LinuxFramebuffer : public GFXcanvas16 {
+  public:
+    LinuxFramebuffer(uint16_t w, uint16_t h) : GFXcanvas16(w, h) {}
+    ~LinuxFramebuffer() { end(); }
+
+    // Maps the framebuffer. False if it can't be opened or mapped, or a
+    // device's visible size isn't the constructor's; without pan support
+    // it stays single buffered (see isDoubleBuffered()).
+    bool begin(const char *path, bool doubleBuffer = false) {
+      end();
+      fd = open(path, O_RDWR);
+      if (fd < 0) return false;
+
+      if (ioctl(fd, FBIOGET_VSCREENINFO, &var) == 0) {
+        if (!setupDevice(doubleBuffer)) {
+          end();
+          return false;
+        }
+      } else {
+        setupFile(doubleBuffer);
+      }
+
+      if (mapBytes < (size_t)stride * (firstRow + pages * HEIGHT)) {
+        end();
+        return false;
+      }
+      void *mapped = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (mapped == MAP_FAILED) {
+        end();
+        return false;
+      }
+      map = static_cast<uint8_t *>(mapped);
+      native565 = var.bits_per_pixel == 16 && var.red.offset == 11 && var.red.length == 5 &&
+                  var.green.offset == 5 && var.green.length == 6 && var.blue.offset == 0;
+
+      // Neither page holds the canvas yet
+      for (uint8_t p = 0; p < pages; p++) held[p].assign((size_t)WIDTH * HEIGHT, 0);
+      invalidate();
+      return true;
+    }
+
+    void end() {
+      if (map) munmap(map, mapBytes);
+      if (fd >= 0) close(fd);
+      map = nullptr;
+      fd = -1;
+      damage.clear();
+      previous.clear();
+    }
+
+    // Copies the damaged areas out, and with two pages flips to the new one
+    void display() {
+      if (!map) return;
+      uint8_t target = pages == 2 ? 1 - shown : shown;
+
+      if (!valid[target]) {
+        copyOut({ 0, 0, WIDTH, HEIGHT }, target);
+        valid[target] = true;
+      } else {
+        for (const Area &a : damage) copyOut(a, target);
+        for (const Area &a : previous) copyOut(a, target);
+      }
+      if (pages == 2) {
+        pan(target);
+        previous.swap(damage);
+      }
+      damage.clear();
+    }
+
+    void setMonochrome(bool on, uint16_t fg = 0xFFFF, uint16_t bg = 0x0000) {
+      if (on != mono || fg != monoFg || bg != monoBg) invalidate();
+      mono = on;
+      monoFg = fg;
+      monoBg = bg;
+    }
+
+    bool isDoubleBuffered() const { return pages == 2; }
+    uint8_t shownPage() const { return shown; }
+    uint64_t bytesWritten() const { return written; }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+      if (x < 0 || y < 0 || x >= width() || y >= height()) return;
+      toRaw(x, y);
+      uint16_t &pixel = getBuffer()[y * WIDTH + x];
+      if (pixel == color) return;
+      pixel = color;
+      addDamage({ x, y, (int16_t)(x + 1), (int16_t)(y + 1) });
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+      fillRect(x, y, w, 1, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+      fillRect(x, y, 1, h, color);
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+      int16_t x1 = min<int16_t>(x + w, width()), y1 = min<int16_t>(y + h, height());
+      x = max<int16_t>(x, 0);
+      y = max<int16_t>(y, 0);
+      if (x >= x1 || y >= y1) return;
+
+      Area raw = toRaw(x, y, x1 - x, y1 - y);
+      Area changed = { raw.x1, raw.y1, raw.x0, raw.y0 };
+      for (int16_t row = raw.y0; row < raw.y1; row++) {
+        uint16_t *pixel = getBuffer() + row * WIDTH;
+        for (int16_t col = raw.x0; col < raw.x1; col++) {
+          if (pixel[col] == color) continue;
+          pixel[col] = color;
+          changed.x0 = min(changed.x0, col);
+          changed.x1 = max<int16_t>(changed.x1, col + 1);
+          changed.y0 = min(changed.y0, row);
+          changed.y1 = row + 1;
+        }
+      }
+      if (changed.x0 < changed.x1) addDamage(changed);
+    }
+
+    void fillScreen(uint16_t color) override {
+      fillRect(0, 0, width(), height(), color);
+    }
+
+  private:
+    // Rectangle in panel (unrotated) coordinates, end exclusive
+    struct Area {
+      int16_t x0, y0, x1, y1;
+    };
+
+    int fd = -1;
+    uint8_t *map = nullptr;
+    size_t mapBytes = 0;
+    uint32_t stride = 0;
+    uint32_t firstRow = 0;    // Where the visible page starts when single buffered
+    fb_var_screeninfo var = {};
+    bool device = false;
+    bool native565 = false;
+    uint8_t pages = 1;
+    uint8_t shown = 0;
+    bool mono = false;
+    uint16_t monoFg = 0xFFFF, monoBg = 0x0000;
+    std::vector<Area> damage, previous;   // previous stays empty with one page
+    std::vector<uint16_t> held[2];        // Canvas pixels as each page has them
+    bool valid[2] = {};                   // False until a page is written in full
+    uint64_t written = 0;
+
+    bool setupDevice(bool doubleBuffer) {
+      device = true;
+      if (var.xres != (uint32_t)WIDTH || var.yres != (uint32_t)HEIGHT) return false;
+      if (var.bits_per_pixel != 16 && var.bits_per_pixel != 24 && var.bits_per_pixel != 32) return false;
+
+      pages = 1;
+      firstRow = var.yoffset;
+      if (doubleBuffer) {
+        if (var.yres_virtual < 2 * var.yres) {
+          fb_var_screeninfo taller = var;
+          taller.yres_virtual = 2 * var.yres;
+          taller.yoffset = 0;
+          if (ioctl(fd, FBIOPUT_VSCREENINFO, &taller) == 0) ioctl(fd, FBIOGET_VSCREENINFO, &var);
+        }
+        if (var.yres_virtual >= 2 * var.yres) {
+          var.yoffset = 0;
+          if (ioctl(fd, FBIOPAN_DISPLAY, &var) == 0) {
+            pages = 2;
+            firstRow = 0;
+          }
+        }
+      }
+
+      fb_fix_screeninfo fix;
+      if (ioctl(fd, FBIOGET_FSCREENINFO, &fix) != 0) return false;
+      stride = fix.line_length;
+      mapBytes = fix.smem_len;
+      shown = 0;
+      return true;
+    }
+
+    void setupFile(bool doubleBuffer) {
+      device = false;
+      var = {};
+      var.xres = var.xres_virtual = WIDTH;
+      var.yres = HEIGHT;
+      var.bits_per_pixel = 16;
+      var.red = { 11, 5, 0 };
+      var.green = { 5, 6, 0 };
+      var.blue = { 0, 5, 0 };
+      pages = doubleBuffer ? 2 : 1;
+      var.yres_virtual = pages * HEIGHT;
+      firstRow = 0;
+      stride = WIDTH * 2;
+      mapBytes = (size_t)stride * pages * HEIGHT;
+      shown = 0;
+
+      struct stat st;
+      if (fstat(fd, &st) == 0 && (size_t)st.st_size < mapBytes) {
+        if (ftruncate(fd, mapBytes) != 0) mapBytes = st.st_size;
+      }
+    }
+
+    void toRaw(int16_t &x, int16_t &y) const {
+      int16_t t;
+      switch (getRotation()) {
+        case 1: t = x; x = WIDTH - 1 - y; y = t; break;
+        case 2: x = WIDTH - 1 - x; y = HEIGHT - 1 - y; break;
+        case 3: t = x; x = y; y = HEIGHT - 1 - t; break;
+      }
+    }
+
+    Area toRaw(int16_t x, int16_t y, int16_t w, int16_t h) const {
+      switch (getRotation()) {
+        case 1: return { (int16_t)(WIDTH - y - h), x, (int16_t)(WIDTH - y), (int16_t)(x + w) };
+        case 2: return { (int16_t)(WIDTH - x - w), (int16_t)(HEIGHT - y - h), (int16_t)(WIDTH - x), (int16_t)(HEIGHT - y) };
+        case 3: return { y, (int16_t)(HEIGHT - x - w), (int16_t)(y + h), (int16_t)(HEIGHT - x) };
+        default: return { x, y, (int16_t)(x + w), (int16_t)(y + h) };
+      }
+    }
+
+    static Area unite(const Area &a, const Area &b) {
+      return { min(a.x0, b.x0), min(a.y0, b.y0), max(a.x1, b.x1), max(a.y1, b.y1) };
+    }
+
+    static int32_t areaOf(const Area &a) {
+      return (int32_t)(a.x1 - a.x0) * (a.y1 - a.y0);
+    }
+
+    void addDamage(const Area &r) {
+      // Pixels of one glyph or line land next to each other; the most
+      // recent rect usually takes them
+      for (size_t i = damage.size(); i-- > 0;) {
+        Area &d = damage[i];
+        if (r.x0 <= d.x1 + FB_DAMAGE_MERGE_GAP && d.x0 <= r.x1 + FB_DAMAGE_MERGE_GAP &&
+            r.y0 <= d.y1 + FB_DAMAGE_MERGE_GAP && d.y0 <= r.y1 + FB_DAMAGE_MERGE_GAP) {
+          d = unite(d, r);
+          return;
+        }
+      }
+      if (damage.size() < FB_MAX_DAMAGE_RECTS) {
+        damage.push_back(r);
+        return;
+      }
+
+      size_t best = 0;
+      int32_t bestGrowth = INT32_MAX;
+      for (size_t i = 0; i < damage.size(); i++) {
+        int32_t growth = areaOf(unite(damage[i], r)) - areaOf(damage[i]);
+        if (growth < bestGrowth) {
+          bestGrowth = growth;
+          best = i;
+        }
+      }
+      damage[best] = unite(damage[best], r);
+    }
+
+    void invalidate() {
+      valid[0] = valid[1] = false;
+      damage.clear();
+      previous.clear();
+    }
+
+    // Writes the part of each row of a that differs from what the page holds
+    void copyOut(const Area &a, uint8_t page) {
+      const uint32_t bytesPerPixel = var.bits_per_pixel / 8;
+      const uint32_t pageRow = pages == 2 ? page * HEIGHT : firstRow;
+      for (int16_t row = a.y0; row < a.y1; row++) {
+        const uint16_t *canvasRow = getBuffer() + row * WIDTH;
+        uint16_t *heldRow = held[page].data() + row * WIDTH;
+        int16_t x0 = a.x0, x1 = a.x1;
+        if (valid[page]) {
+          while (x0 < x1 && canvasRow[x0] == heldRow[x0]) x0++;
+          while (x1 > x0 && canvasRow[x1 - 1] == heldRow[x1 - 1]) x1--;
+          if (x0 == x1) continue;
+        }
+
+        const uint16_t *src = canvasRow + x0;
+        uint8_t *dst = map + (size_t)(pageRow + row) * stride + x0 * bytesPerPixel;
+        int16_t count = x1 - x0;
+        memcpy(heldRow + x0, src, count * 2);
+        if (native565 && !mono) {
+          memcpy(dst, src, count * 2);
+        } else {
+          for (int16_t i = 0; i < count; i++, dst += bytesPerPixel) pack(src[i], dst, bytesPerPixel);
+        }
+        written += count * bytesPerPixel;
+      }
+    }
+
+    void pack(uint16_t color, uint8_t *dst, uint32_t bytesPerPixel) const {
+      if (mono) color = color ? monoFg : monoBg;
+      uint32_t r = (color >> 11) & 0x1F, g = (color >> 5) & 0x3F, b = color & 0x1F;
+      r = (r << 3) | (r >> 2);
+      g = (g << 2) | (g >> 4);
+      b = (b << 3) | (b >> 2);
+      uint32_t value = ((r >> (8 - var.red.length)) << var.red.offset) |
+                       ((g >> (8 - var.green.length)) << var.green.offset) |
+                       ((b >> (8 - var.blue.length)) << var.blue.offset);
+      if (var.transp.length) value |= ((1u << var.transp.length) - 1) << var.transp.offset;
+      for (uint32_t i = 0; i < bytesPerPixel; i++) dst[i] = value >> (8 * i);
+    }
+
+    void pan(uint8_t page) {
+      if (device) {
+        var.yoffset = page * HEIGHT;
+        if (ioctl(fd, FBIOPAN_DISPLAY, &var) != 0) return;
+      }
+      shown = page;
+    }
+};
+
+#endif // __linux__
+
+#endif // LINUX_FRAMEBUFFER_H
@@ -23,7 +23,6 @@ class Screen;
 class Button;
 class Label;
 class ProgressBar;
-class FloatDisplay;
 class FunctionPlotter;
 
 // Input event structure
@@ -196,53 +195,77 @@ public:
 };
 
 // Float Display widget
+// Number with a unit. Precision (decimals), Width (characters of the
+// number, sign and point included), the unit text and the deadband (in
+// counts of the last digit) are template arguments, so the scale factor
+// and every glyph position are compile-time constants and setValue() is a
+// multiply and an integer compare. The UI manager clears and repaints the
+// whole frame, so draw() renders the full fixed-width field, without printf.
+template <uint8_t Precision, uint8_t Width, const char* Unit, uint8_t Deadband = 1>
 class FloatDisplay : public Widget {
-private:
-    float value;
-    uint8_t precision;
-    char format[16];
-    char label[32];
-    bool showLabel;
+    static_assert(Width > Precision + (Precision ? 1 : 0), "Width must fit the decimals");
+    static_assert(Width <= 12, "Width is limited to 12 characters");
     
-public:
-    FloatDisplay(int16_t x, int16_t y, int16_t w, int16_t h, 
-                uint8_t precision = 2, const char* label = nullptr)
-        : Widget(x, y, w, h), value(0.0f), precision(precision) {
-        snprintf(format, sizeof(format), "%%.%df", precision);
-        if (label) {
-            strncpy(this->label, label, sizeof(this->label) - 1);
-            this->label[sizeof(this->label) - 1] = '\0';
-            showLabel = true;
-        } else {
-            showLabel = false;
+private:
+    static constexpr int32_t pow10(uint8_t n) { return n == 0 ? 1 : 10 * pow10(n - 1); }
+    static constexpr float SCALE = pow10(Precision);
+    static constexpr int16_t CHAR_W = 6;
+    static constexpr int16_t UNIT_OFFSET = (Width + 1) * CHAR_W;
+    
+    int32_t scaled;          // Value in counts of the last digit
+    
+    // Right-aligned fixed-width rendering of scaled; dashes if it won't fit
+    static void format(int32_t value, char* out) {
+        uint32_t v = value < 0 ? -value : value;
+        int8_t pos = Width;
+        bool fits = false;
+        for (uint8_t d = 0; ; d++) {
+            if (Precision > 0 && d == Precision) {
+                if (--pos < 0) break;
+                out[pos] = '.';
+            }
+            if (--pos < 0) break;
+            out[pos] = '0' + v % 10;
+            v /= 10;
+            if (v == 0 && d >= Precision) {
+                fits = true;
+                break;
+            }
+        }
+        if (fits && value < 0) {
+            fits = --pos >= 0;
+            if (fits) out[pos] = '-';
         }
+        if (!fits) {
+            memset(out, '-', Width);
+            return;
+        }
+        memset(out, ' ', pos);
     }
     
+public:
+    FloatDisplay(int16_t x, int16_t y, int16_t w, int16_t h)
+        : Widget(x, y, w, h), scaled(0) {}
+    
     void setValue(float newValue) {
-        if (abs(newValue - value) > pow(10, -precision)) {
-            value = newValue;
+        int32_t s = lroundf(newValue * SCALE);
+        if (abs(s - scaled) >= Deadband) {
+            scaled = s;
             dirty = true;
         }
     }
     
+    float getValue() const { return scaled / SCALE; }
+    
     void draw(Adafruit_SSD1306& display) override {
-        display.setTextColor(WHITE);
-        
-        char valueStr[16];
-        snprintf(valueStr, sizeof(valueStr), format, value);
-        
-        if (showLabel) {
-            display.setCursor(x, y);
-            display.print(label);
-            display.print(": ");
-            int16_t valueWidth = strlen(valueStr) * 6;
-            display.setCursor(x + width - valueWidth, y);
-        } else {
-            int16_t valueWidth = strlen(valueStr) * 6;
-            display.setCursor(x + (width - valueWidth) / 2, y + (height - 8) / 2);
+        char text[Width];
+        format(scaled, text);
+        for (uint8_t i = 0; i < Width; i++) {
+            display.drawChar(x + i * CHAR_W, y, text[i], WHITE, BLACK, 1);
         }
-        
-        display.print(valueStr);
+        display.setTextColor(WHITE);
+        display.setCursor(x + UNIT_OFFSET, y);
+        display.print(Unit);
         
         if (focused) {
             display.drawRect(x, y, width, height, WHITE);
@@ -482,6 +505,12 @@ float capacityMah = 0.0f;
 unsigned long chargeStartTime = 0;
 bool charging = false;
 
+// Main screen readouts; 0.2 C deadband keeps ADC noise off the display
+constexpr char UNIT_TEMP[] = "Temp C";
+constexpr char UNIT_MAH[] = "mAh";
+typedef FloatDisplay<1, 5, UNIT_TEMP, 2> TempDisplay;
+typedef FloatDisplay<0, 5, UNIT_MAH> CapacityDisplay;
+
 // Voltage measurement history for -dV detection
 const int VOLTAGE_HISTORY_SIZE = 60;  // 1 minute history at 1s intervals
 float voltageHistory[VOLTAGE_HISTORY_SIZE];
@@ -554,9 +583,8 @@ void setup() {
     
     mainScreen->addWidget(new Label(0, 0, 128, 10, "NiMH Charger", true));
     mainScreen->addWidget(new BatteryWidget(0, 12, 128, 20));
-    mainScreen ```cpp
-->addWidget(new FloatDisplay(0, 34, 128, 10, 1, "Temp C"));
-    mainScreen->addWidget(new FloatDisplay(0, 44, 128, 10, 0, "mAh"));
+    mainScreen->addWidget(new TempDisplay(0, 34, 128, 10));
+    mainScreen->addWidget(new CapacityDisplay(0, 44, 128, 10));
     mainScreen->addWidget(new Button(14, 54, 100, 10, "Start Charging", startCharging));
     
     ui.setScreen(mainScreen);
@@ -650,8 +678,8 @@ void updateCharging() {
         }
         
         ((BatteryWidget*)mainScreen->getWidget(1))->updateValues(batteryVoltage, chargeCurrent);
-        ((FloatDisplay*)mainScreen->getWidget(2))->setValue(temperature);
-        ((FloatDisplay*)mainScreen->getWidget(3))->setValue(capacityMah);
+        ((TempDisplay*)mainScreen->getWidget(2))->setValue(temperature);
+        ((CapacityDisplay*)mainScreen->getWidget(3))->setValue(capacityMah);
         ((Label*)mainScreen->getWidget(0))->setText(getStateString());
     }
 }
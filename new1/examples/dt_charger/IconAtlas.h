@@ -0,0 +1,157 @@
+#ifndef ICON_ATLAS_H
+#define ICON_ATLAS_H
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+
+// One icon in the atlas: its packed stream and size in pixels
+struct IconInfo {
+    const uint8_t* data;
+    uint8_t width;
+    uint8_t height;
+};
+
+#include "IconAtlasData.h"   // Generated, see tools/make_icon_atlas.py
+
+// Status icons stored run-length packed in flash (see the generator for the
+// stream format) and unpacked straight into their destination: the SSD1306
+// page buffer for the OLED, or a caller's line buffer for a TFT. Nothing is
+// unpacked into a temporary bitmap first, and icons can sit at any x/y.
+namespace IconAtlas {
+
+    // Sequential reader for a packed stream of ITEM_BYTES-sized items
+    template <uint8_t ITEM_BYTES>
+    class RunReader {
+    public:
+        explicit RunReader(const uint8_t* data) : src(data), left(0), repeat(false), item(0) {}
+
+        uint16_t next() {
+            if (left == 0) {
+                uint8_t control = *src++;
+                repeat = control & 0x80;
+                left = (control & 0x7F) + 1;
+                if (repeat) item = read();
+            }
+            left--;
+            return repeat ? item : read();
+        }
+
+    private:
+        const uint8_t* src;
+        uint8_t left;
+        bool repeat;
+        uint16_t item;
+
+        uint16_t read() {
+            uint16_t value = *src++;
+            if (ITEM_BYTES == 2) value = (value << 8) | *src++;
+            return value;
+        }
+    };
+
+    inline const IconInfo* mono(IconId id) { return id < ICON_COUNT ? &ICON_MONO[id] : nullptr; }
+    inline const IconInfo* rgb565(IconId id) { return id < ICON_COUNT ? &ICON_RGB565[id] : nullptr; }
+
+    // Draws a 1 bpp icon opaquely (unset pixels are cleared). The packed
+    // columns are already in page layout, so each one lands in at most two
+    // frame buffer bytes: shifted down by y & 7, and the remainder in the
+    // next page.
+    inline void draw(Adafruit_SSD1306& display, IconId id, int16_t x, int16_t y) {
+        const IconInfo* icon = mono(id);
+        if (!icon) return;
+
+        RunReader<1> columns(icon->data);
+        uint8_t* fb = display.getBuffer();
+
+        for (uint8_t page = 0; page * 8 < icon->height; page++) {
+            uint8_t rows = min<int16_t>(8, icon->height - page * 8);
+            uint8_t valid = 0xFF >> (8 - rows);
+            int16_t top = y + page * 8;
+            int16_t dstPage = top >> 3;        // Floor, also for negative y
+            uint8_t shift = top & 7;
+
+            for (uint8_t c = 0; c < icon->width; c++) {
+                uint8_t bits = columns.next();
+                int16_t dx = x + c;
+                if (dx < 0 || dx >= display.width()) continue;
+
+                if ((PANEL_ROTATION & 1) != 0) {
+                    // Transposed panels don't map columns to page bytes
+                    for (uint8_t r = 0; r < rows; r++) {
+                        display.drawPixel(dx, top + r, (bits >> r) & 1 ? WHITE : BLACK);
+                    }
+                    continue;
+                }
+
+                if (dstPage >= 0 && dstPage < SCREEN_HEIGHT / 8) {
+                    uint8_t mask = valid << shift;
+                    uint8_t& dst = fb[dstPage * SCREEN_WIDTH + dx];
+                    dst = (dst & ~mask) | ((bits << shift) & mask);
+                }
+                if (shift && dstPage + 1 >= 0 && dstPage + 1 < SCREEN_HEIGHT / 8) {
+                    uint8_t mask = valid >> (8 - shift);
+                    uint8_t& dst = fb[(dstPage + 1) * SCREEN_WIDTH + dx];
+                    dst = (dst & ~mask) | ((bits >> (8 - shift)) & mask);
+                }
+            }
+        }
+    }
+
+    // Unpacks an RGB565 icon one row at a time, top to bottom, for
+    // renderers that build the screen in line buffers (or DMA chunks).
+    class RowDecoder {
+    public:
+        explicit RowDecoder(IconId id)
+            : icon(rgb565(id)), pixels(icon ? icon->data : nullptr), row(0) {}
+
+        bool valid() const { return icon != nullptr; }
+        uint8_t width() const { return icon->width; }
+        uint8_t height() const { return icon->height; }
+        bool done() const { return row >= icon->height; }
+
+        // Writes icon columns [from, from + count) of the next row to out
+        void nextRow(uint16_t* out, int16_t from = 0, int16_t count = INT16_MAX) {
+            for (int16_t c = 0; c < icon->width; c++) {
+                uint16_t color = pixels.next();
+                if (c >= from && c - from < count) *out++ = color;
+            }
+            row++;
+        }
+
+        void skipRows(int16_t n) {
+            for (int32_t i = (int32_t)n * icon->width; i > 0; i--) pixels.next();
+            row += n;
+        }
+
+    private:
+        const IconInfo* icon;
+        RunReader<2> pixels;
+        int16_t row;
+    };
+
+    // Draws an RGB565 icon on an Adafruit_SPITFT display, clipped to the
+    // screen, with one address window and a row-sized stack buffer.
+    template <typename TFT>
+    void draw565(TFT& tft, IconId id, int16_t x, int16_t y) {
+        RowDecoder icon(id);
+        if (!icon.valid()) return;
+
+        int16_t x0 = max<int16_t>(x, 0), y0 = max<int16_t>(y, 0);
+        int16_t x1 = min<int16_t>(x + icon.width(), tft.width());
+        int16_t y1 = min<int16_t>(y + icon.height(), tft.height());
+        if (x0 >= x1 || y0 >= y1) return;
+
+        uint16_t line[ICON_MAX_WIDTH];
+        icon.skipRows(y0 - y);
+
+        tft.startWrite();
+        tft.setAddrWindow(x0, y0, x1 - x0, y1 - y0);
+        for (int16_t r = y0; r < y1; r++) {
+            icon.nextRow(line, x0 - x, x1 - x0);
+            tft.writePixels(line, x1 - x0);
+        }
+        tft.endWrite();
+    }
+}
+
+#endif // ICON_ATLAS_H
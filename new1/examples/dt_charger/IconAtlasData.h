@@ -0,0 +1,83 @@
+// Generated by tools/make_icon_atlas.py from icons/icons.txt - do not edit
+// 1 bpp: 54 bytes (48 raw), RGB565: 400 bytes (768 raw)
+
+#ifndef ICON_ATLAS_DATA_H
+#define ICON_ATLAS_DATA_H
+
+enum IconId : uint8_t {
+    ICON_CHARGING,
+    ICON_TRICKLE,
+    ICON_COMPLETE,
+    ICON_ERROR,
+    ICON_TEMPERATURE,
+    ICON_IR,
+    ICON_COUNT,
+    ICON_NONE = 0xFF
+};
+
+#define ICON_MAX_WIDTH 8
+
+static const uint8_t ICON_MONO_DATA[] = {
+    0x07, 0x00, 0x88, 0xCC, 0x6E, 0x3B, 0x19, 0x08, 0x00, 0x07, 0x00, 0x30,
+    0x7C, 0xFF, 0xFF, 0x7C, 0x30, 0x00, 0x07, 0x18, 0x30, 0x60, 0x60, 0x30,
+    0x18, 0x0C, 0x06, 0x07, 0xE0, 0xF8, 0xFE, 0xFF, 0xFF, 0xFE, 0xF8, 0xE0,
+    0x07, 0x00, 0x60, 0xFE, 0xF9, 0xF9, 0xFE, 0x60, 0x00, 0x07, 0x18, 0x00,
+    0x42, 0x24, 0x18, 0x00, 0xBD, 0x42,
+};
+
+static const uint8_t ICON_RGB565_DATA[] = {
+    0x83, 0x00, 0x00, 0x81, 0xFF, 0xE0, 0x84, 0x00, 0x00, 0x81, 0xFF, 0xE0,
+    0x84, 0x00, 0x00, 0x81, 0xFF, 0xE0, 0x84, 0x00, 0x00, 0x85, 0xFF, 0xE0,
+    0x84, 0x00, 0x00, 0x81, 0xFF, 0xE0, 0x84, 0x00, 0x00, 0x81, 0xFF, 0xE0,
+    0x84, 0x00, 0x00, 0x81, 0xFF, 0xE0, 0x84, 0x00, 0x00, 0x81, 0xFF, 0xE0,
+    0x84, 0x00, 0x00, 0x82, 0x00, 0x00, 0x81, 0x00, 0x1F, 0x85, 0x00, 0x00,
+    0x81, 0x00, 0x1F, 0x84, 0x00, 0x00, 0x83, 0x00, 0x1F, 0x83, 0x00, 0x00,
+    0x83, 0x00, 0x1F, 0x82, 0x00, 0x00, 0x81, 0x00, 0x1F, 0x00, 0x07, 0xFF,
+    0x82, 0x00, 0x1F, 0x81, 0x00, 0x00, 0x81, 0x00, 0x1F, 0x00, 0x07, 0xFF,
+    0x82, 0x00, 0x1F, 0x82, 0x00, 0x00, 0x83, 0x00, 0x1F, 0x84, 0x00, 0x00,
+    0x81, 0x00, 0x1F, 0x82, 0x00, 0x00, 0x8E, 0x00, 0x00, 0x00, 0x07, 0xE0,
+    0x85, 0x00, 0x00, 0x82, 0x07, 0xE0, 0x83, 0x00, 0x00, 0x81, 0x07, 0xE0,
+    0x00, 0x00, 0x00, 0x81, 0x07, 0xE0, 0x81, 0x00, 0x00, 0x81, 0x07, 0xE0,
+    0x82, 0x00, 0x00, 0x83, 0x07, 0xE0, 0x84, 0x00, 0x00, 0x81, 0x07, 0xE0,
+    0x8B, 0x00, 0x00, 0x82, 0x00, 0x00, 0x81, 0xF8, 0x00, 0x84, 0x00, 0x00,
+    0x83, 0xF8, 0x00, 0x83, 0x00, 0x00, 0x00, 0xF8, 0x00, 0x81, 0xFF, 0xFF,
+    0x00, 0xF8, 0x00, 0x82, 0x00, 0x00, 0x81, 0xF8, 0x00, 0x81, 0xFF, 0xFF,
+    0x81, 0xF8, 0x00, 0x81, 0x00, 0x00, 0x81, 0xF8, 0x00, 0x81, 0xFF, 0xFF,
+    0x81, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x8A, 0xF8, 0x00, 0x81, 0xFF, 0xFF,
+    0x8A, 0xF8, 0x00, 0x82, 0x00, 0x00, 0x81, 0xFF, 0xFF, 0x84, 0x00, 0x00,
+    0x00, 0xFF, 0xFF, 0x81, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x83, 0x00, 0x00,
+    0x00, 0xFF, 0xFF, 0x81, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x83, 0x00, 0x00,
+    0x00, 0xFF, 0xFF, 0x81, 0xFD, 0x20, 0x00, 0xFF, 0xFF, 0x83, 0x00, 0x00,
+    0x00, 0xFF, 0xFF, 0x81, 0xFD, 0x20, 0x00, 0xFF, 0xFF, 0x82, 0x00, 0x00,
+    0x01, 0xFF, 0xFF, 0xF8, 0x00, 0x81, 0xFD, 0x20, 0x01, 0xF8, 0x00, 0xFF,
+    0xFF, 0x81, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x83, 0xF8, 0x00, 0x00, 0xFF,
+    0xFF, 0x82, 0x00, 0x00, 0x83, 0xFF, 0xFF, 0x81, 0x00, 0x00, 0x85, 0x00,
+    0x00, 0x00, 0x07, 0xFF, 0x82, 0x00, 0x00, 0x00, 0x07, 0xFF, 0x83, 0x00,
+    0x00, 0x00, 0x07, 0xFF, 0x82, 0x00, 0x00, 0x00, 0x07, 0xFF, 0x81, 0x00,
+    0x00, 0x02, 0x07, 0xFF, 0x00, 0x00, 0x07, 0xFF, 0x82, 0x00, 0x00, 0x04,
+    0x07, 0xFF, 0x00, 0x00, 0x07, 0xFF, 0x00, 0x00, 0x07, 0xFF, 0x82, 0x00,
+    0x00, 0x02, 0x07, 0xFF, 0x00, 0x00, 0x07, 0xFF, 0x83, 0x00, 0x00, 0x00,
+    0x07, 0xFF, 0x81, 0x00, 0x00, 0x00, 0x07, 0xFF, 0x82, 0x00, 0x00, 0x00,
+    0x07, 0xFF, 0x83, 0x00, 0x00, 0x00, 0x07, 0xFF, 0x85, 0x00, 0x00, 0x01,
+    0x07, 0xFF, 0x00, 0x00,
+};
+
+static const IconInfo ICON_MONO[ICON_COUNT] = {
+    { ICON_MONO_DATA + 0, 8, 8 },   // CHARGING
+    { ICON_MONO_DATA + 9, 8, 8 },   // TRICKLE
+    { ICON_MONO_DATA + 18, 8, 8 },   // COMPLETE
+    { ICON_MONO_DATA + 27, 8, 8 },   // ERROR
+    { ICON_MONO_DATA + 36, 8, 8 },   // TEMPERATURE
+    { ICON_MONO_DATA + 45, 8, 8 },   // IR
+};
+
+static const IconInfo ICON_RGB565[ICON_COUNT] = {
+    { ICON_RGB565_DATA + 0, 8, 8 },   // CHARGING
+    { ICON_RGB565_DATA + 51, 8, 8 },   // TRICKLE
+    { ICON_RGB565_DATA + 114, 8, 8 },   // COMPLETE
+    { ICON_RGB565_DATA + 159, 8, 8 },   // ERROR
+    { ICON_RGB565_DATA + 219, 8, 8 },   // TEMPERATURE
+    { ICON_RGB565_DATA + 310, 8, 8 },   // IR
+};
+
+#endif // ICON_ATLAS_DATA_H
@@ -0,0 +1,109 @@
+#ifndef ORIENTED_SSD1306_H
+#define ORIENTED_SSD1306_H
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+
+// SSD1306 driver with the panel orientation fixed at compile time.
+//
+// Adafruit_SSD1306 resolves setRotation() inside every drawPixel and
+// drawFastHLine/VLine call. Our panels are mounted once, so the orientation
+// is a template parameter instead:
+//   - the 180 degree part is done by the controller itself (segment remap
+//     and COM scan direction are set once in begin()),
+//   - portrait mounts (1 and 3) only swap x/y, and that swap is compiled in.
+// The GFX rotation stays 0, so no primitive ever takes the rotation switch.
+template <uint8_t ROTATION>
+class OrientedSSD1306 : public Adafruit_SSD1306 {
+    static_assert(ROTATION < 4, "ROTATION must be 0..3");
+
+    static constexpr bool TRANSPOSED = ROTATION & 1;
+
+public:
+    OrientedSSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rstPin)
+        : Adafruit_SSD1306(w, h, twi, rstPin) {
+        if (TRANSPOSED) {
+            _width = h;
+            _height = w;
+        }
+    }
+
+    bool begin(uint8_t vccState = SSD1306_SWITCHCAPVCC, uint8_t i2cAddr = 0) {
+        if (!Adafruit_SSD1306::begin(vccState, i2cAddr)) return false;
+
+        // Rotation 0 is the library default (A1/C8); the others mirror
+        // columns and/or rows in hardware.
+        ssd1306_command(ROTATION == 0 || ROTATION == 3 ? SSD1306_SEGREMAP | 0x1 : SSD1306_SEGREMAP);
+        ssd1306_command(ROTATION < 2 ? SSD1306_COMSCANDEC : SSD1306_COMSCANINC);
+        return true;
+    }
+
+    // Orientation is fixed by the template argument.
+    void setRotation(uint8_t) override {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if ((uint16_t)x >= (uint16_t)_width || (uint16_t)y >= (uint16_t)_height) return;
+        if constexpr (TRANSPOSED) {
+            fillPhysical(y, x, 1, 1, color);
+        } else {
+            fillPhysical(x, y, 1, 1, color);
+        }
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+        fillRect(x, y, w, 1, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+        fillRect(x, y, 1, h, color);
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+        // Clip in logical coordinates
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > _width) w = _width - x;
+        if (y + h > _height) h = _height - y;
+        if (w <= 0 || h <= 0) return;
+
+        // A logical span is a physical span of the other direction when transposed
+        if constexpr (TRANSPOSED) {
+            fillPhysical(y, x, h, w, color);
+        } else {
+            fillPhysical(x, y, w, h, color);
+        }
+    }
+
+    bool getPixel(int16_t x, int16_t y) {
+        if ((uint16_t)x >= (uint16_t)_width || (uint16_t)y >= (uint16_t)_height) return false;
+        if constexpr (TRANSPOSED) {
+            int16_t t = x;
+            x = y;
+            y = t;
+        }
+        return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+    }
+
+private:
+    // Writes an already clipped rectangle straight into the page buffer,
+    // one page (8 rows) at a time.
+    void fillPhysical(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        while (h > 0) {
+            uint8_t bit = y & 7;
+            uint8_t span = min<int16_t>(8 - bit, h);
+            uint8_t mask = ((1 << span) - 1) << bit;
+            uint8_t* p = &buffer[x + (y / 8) * WIDTH];
+
+            switch (color) {
+                case WHITE:   for (int16_t i = 0; i < w; i++) p[i] |= mask; break;
+                case BLACK:   for (int16_t i = 0; i < w; i++) p[i] &= ~mask; break;
+                case INVERSE: for (int16_t i = 0; i < w; i++) p[i] ^= mask; break;
+            }
+
+            y += span;
+            h -= span;
+        }
+    }
+};
+
+#endif // ORIENTED_SSD1306_H
@@ -0,0 +1,140 @@
+#ifndef RENDER_CACHE_H
+#define RENDER_CACHE_H
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+
+// Helpers for moving rectangles in and out of the SSD1306 frame buffer in
+// its native layout: pages of 8 rows, one byte per column. A rect that
+// doesn't start or end on a page boundary is masked at the top and bottom.
+namespace PageBitmap {
+    inline uint8_t firstPage(int16_t y) { return y / 8; }
+    inline uint8_t pageCount(int16_t y, int16_t h) { return (y + h - 1) / 8 - y / 8 + 1; }
+    inline uint16_t byteSize(int16_t y, int16_t w, int16_t h) { return w * pageCount(y, h); }
+
+    // Rows of page p that belong to [y, y + h)
+    inline uint8_t rowMask(uint8_t p, int16_t y, int16_t h) {
+        uint8_t mask = 0xFF;
+        if (p == firstPage(y)) mask &= 0xFF << (y & 7);
+        if (p == (y + h - 1) / 8) mask &= 0xFF >> (7 - ((y + h - 1) & 7));
+        return mask;
+    }
+
+    // Copies the rect out of the frame buffer into dst (w bytes per page)
+    inline void capture(Adafruit_SSD1306& display, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t* dst) {
+        const uint8_t* fb = display.getBuffer();
+        for (uint8_t p = firstPage(y); p <= (y + h - 1) / 8; p++) {
+            memcpy(dst, fb + p * SCREEN_WIDTH + x, w);
+            dst += w;
+        }
+    }
+
+    // Writes src (as produced by capture) back into the frame buffer;
+    // rows outside [y, y + h) are left untouched. A stride wider than w
+    // blits a window out of a wider source.
+    inline void blit(Adafruit_SSD1306& display, int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* src,
+                     int16_t stride = 0) {
+        uint8_t* fb = display.getBuffer();
+        if (stride == 0) stride = w;
+        for (uint8_t p = firstPage(y); p <= (y + h - 1) / 8; p++) {
+            uint8_t mask = rowMask(p, y, h);
+            uint8_t* row = fb + p * SCREEN_WIDTH + x;
+            if (mask == 0xFF) {
+                memcpy(row, src, w);
+            } else {
+                for (int16_t i = 0; i < w; i++) {
+                    row[i] = (row[i] & ~mask) | (src[i] & mask);
+                }
+            }
+            src += stride;
+        }
+    }
+}
+
+// Small LRU of rendered widget states, keyed by (widget, value id).
+// Widgets with a handful of recurring looks (status texts, button labels)
+// render a state once, store it, and from then on redraw it with a single
+// page blit instead of rasterizing the font again.
+class RenderCache {
+public:
+    static const uint8_t ENTRIES = 8;
+    static const uint16_t MAX_BYTES = SCREEN_WIDTH * 2;   // A full-width rect spanning two pages
+
+    // FNV-1a; good enough to tell a few dozen strings apart
+    static uint32_t hash(const char* text, uint32_t seed = 2166136261u) {
+        uint32_t h = seed;
+        while (*text) {
+            h = (h ^ (uint8_t)*text++) * 16777619u;
+        }
+        return h;
+    }
+
+    RenderCache() : useCounter(0) {
+        for (auto& e : entries) e.owner = nullptr;
+    }
+
+    // Draws a cached state; returns false on a miss
+    bool blit(Adafruit_SSD1306& display, const void* owner, uint32_t valueId,
+              int16_t x, int16_t y, int16_t w, int16_t h) {
+        Entry* e = find(owner, valueId, x, y, w, h);
+        if (!e) return false;
+        e->lastUse = ++useCounter;
+        PageBitmap::blit(display, x, y, w, h, e->bytes);
+        return true;
+    }
+
+    // Stores the rect as just rendered into the frame buffer
+    void store(Adafruit_SSD1306& display, const void* owner, uint32_t valueId,
+               int16_t x, int16_t y, int16_t w, int16_t h) {
+        if (!cacheable(x, y, w, h)) return;
+
+        Entry* victim = &entries[0];
+        for (auto& e : entries) {
+            if (!e.owner) { victim = &e; break; }
+            if (e.lastUse < victim->lastUse) victim = &e;
+        }
+
+        *victim = { owner, valueId, ++useCounter, x, y, w, h };
+        PageBitmap::capture(display, x, y, w, h, victim->bytes);
+    }
+
+    // Drops every state of a widget that is going away
+    void evict(const void* owner) {
+        for (auto& e : entries) {
+            if (e.owner == owner) e.owner = nullptr;
+        }
+    }
+
+private:
+    struct Entry {
+        const void* owner;
+        uint32_t valueId;
+        uint32_t lastUse;
+        int16_t x, y, w, h;
+        uint8_t bytes[MAX_BYTES];
+    };
+
+    Entry entries[ENTRIES];
+    uint32_t useCounter;
+
+    // Page blits assume the frame buffer isn't transposed
+    static bool cacheable(int16_t x, int16_t y, int16_t w, int16_t h) {
+        return (PANEL_ROTATION & 1) == 0 && x >= 0 && y >= 0 && w > 0 && h > 0 &&
+               x + w <= SCREEN_WIDTH && y + h <= SCREEN_HEIGHT &&
+               PageBitmap::byteSize(y, w, h) <= MAX_BYTES;
+    }
+
+    Entry* find(const void* owner, uint32_t valueId, int16_t x, int16_t y, int16_t w, int16_t h) {
+        for (auto& e : entries) {
+            if (e.owner == owner && e.valueId == valueId &&
+                e.x == x && e.y == y && e.w == w && e.h == h) {
+                return &e;
+            }
+        }
+        return nullptr;
+    }
+};
+
+inline RenderCache renderCache;
+
+#endif // RENDER_CACHE_H
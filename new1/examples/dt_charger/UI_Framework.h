@@ -7,12 +7,18 @@
 #include <IRremote.h>
 #include <vector>
 #include <functional>
+#include <initializer_list>
+#include "OrientedSSD1306.h"
 
 // Display settings
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define OLED_RESET -1
 #define SCREEN_ADDRESS 0x3C
+#define PANEL_ROTATION 0      // Fixed mounting orientation (0-3), see OrientedSSD1306.h
+
+#include "RenderCache.h"
+#include "IconAtlas.h"
 
 // Pin definitions
 #define IR_RECEIVE_PIN 15
@@ -62,7 +68,8 @@ enum ChargerState {
 // Screen identifiers
 enum ScreenType {
     MAIN_SCREEN,
-    GRAPH_SCREEN
+    GRAPH_SCREEN,
+    STATS_SCREEN
 };
 
 // Graph types
@@ -91,12 +98,21 @@ public:
     Widget(int16_t x, int16_t y, int16_t w, int16_t h) 
         : x(x), y(y), width(w), height(h), focused(false), dirty(true) {}
     
-    virtual ~Widget() {}
+    virtual ~Widget() { renderCache.evict(this); }
     
     virtual void draw(Adafruit_SSD1306& display) = 0;
     virtual void handleInput(const InputEvent& event) = 0;
     virtual void update() = 0;
     
+    // Incremental widgets keep track of what they have on screen and only
+    // repaint the difference; all others get their rect cleared before draw()
+    virtual bool drawsIncrementally() const { return false; }
+    
+    // Forget what is on screen (called after the display was cleared)
+    virtual void invalidate() { dirty = true; }
+    
+    void clear(Adafruit_SSD1306& display) { display.fillRect(x, y, width, height, BLACK); }
+    
     void setFocus(bool focus) { focused = focus; dirty = true; }
     bool isFocused() const { return focused; }
     bool isDirty() const { return dirty; }
@@ -153,12 +169,21 @@ public:
     void draw(Adafruit_SSD1306& display) {
         for (auto widget : widgets) {
             if (widget->isDirty()) {
+                if (!widget->drawsIncrementally()) {
+                    widget->clear(display);
+                }
                 widget->draw(display);
                 widget->clearDirty();
             }
         }
     }
     
+    void invalidate() {
+        for (auto widget : widgets) {
+            widget->invalidate();
+        }
+    }
+    
 private:
     void changeFocus(int direction) {
         if (widgets.empty()) return;
@@ -190,7 +215,14 @@ public:
         dirty = true;
     }
     
+    // Each (label, focus) combination is rendered once and then blitted
+    bool drawsIncrementally() const override { return true; }
+    
     void draw(Adafruit_SSD1306& display) override {
+        uint32_t id = RenderCache::hash(label, focused ? 1 : 2);
+        if (renderCache.blit(display, this, id, x, y, width, height)) return;
+        
+        clear(display);
         display.drawRect(x, y, width, height, WHITE);
         if (focused) {
             display.fillRect(x + 2, y + 2, width - 4, height - 4, WHITE);
@@ -203,6 +235,8 @@ public:
         int16_t textY = y + (height - 8) / 2;
         display.setCursor(textX, textY);
         display.print(label);
+        
+        renderCache.store(display, this, id, x, y, width, height);
     }
     
     void handleInput(const InputEvent& event) override {
@@ -231,7 +265,15 @@ public:
         }
     }
     
+    // Labels cycling through a few fixed texts (e.g. charger states) hit
+    // the render cache after the first time each text is shown
+    bool drawsIncrementally() const override { return true; }
+    
     void draw(Adafruit_SSD1306& display) override {
+        uint32_t id = RenderCache::hash(text.c_str());
+        if (renderCache.blit(display, this, id, x, y, width, height)) return;
+        
+        clear(display);
         display.setTextColor(WHITE);
         if (centered) {
             int16_t textX = x + (width - text.length() * 6) / 2;
@@ -240,36 +282,326 @@ public:
             display.setCursor(x, y);
         }
         display.print(text);
+        
+        renderCache.store(display, this, id, x, y, width, height);
     }
     
     void handleInput(const InputEvent& event) override {}
     void update() override {}
 };
 
+// MarqueeLabel widget
+// Label for texts that may be wider than its rect. A text that doesn't fit
+// is rasterized once, when it is set, into a strip in the frame buffer's
+// page layout (with the same row offset as y); scrolling then just blits a
+// moving window of that strip, wrapping around after a gap. Texts that fit
+// are drawn statically through the render cache, like Label.
+//
+// SSD1306 hardware scrolling is not used: it shifts whole pages of GDDRAM
+// across the full panel width, and the next display() overwrites the
+// scrolled RAM from the frame buffer anyway.
+class MarqueeLabel : public Widget {
+private:
+    static const int16_t GAP = 24;     // Blank columns between repeats
+    
+    String text;
+    uint16_t speed;                    // Pixels per second
+    uint8_t* strip;                    // stripWidth columns per page, nullptr if the text fits
+    int16_t stripWidth;
+    int16_t offset;                    // First strip column in the window
+    unsigned long startTime;
+    
+    void render() {
+        free(strip);
+        strip = nullptr;
+        offset = 0;
+        startTime = millis();
+        
+        int16_t textWidth = text.length() * 6;
+        if (textWidth <= width) return;
+        
+        stripWidth = textWidth + GAP;
+        uint8_t pages = PageBitmap::pageCount(y, height);
+        strip = (uint8_t*)calloc(stripWidth * pages, 1);
+        if (!strip) return;
+        
+        // Rasterize at the same row offset within a page as y, so pages
+        // of the strip line up with pages of the frame buffer
+        int16_t rowOffset = y & 7;
+        GFXcanvas1 canvas(stripWidth, pages * 8);
+        canvas.setTextWrap(false);
+        canvas.setTextColor(1);
+        canvas.setCursor(0, rowOffset + (height - 8) / 2);
+        canvas.print(text);
+        
+        for (uint8_t p = 0; p < pages; p++) {
+            for (int16_t c = 0; c < stripWidth; c++) {
+                uint8_t bits = 0;
+                for (uint8_t b = 0; b < 8; b++) {
+                    int16_t row = p * 8 + b;
+                    if (row >= rowOffset && row < rowOffset + height && canvas.getPixel(c, row)) {
+                        bits |= 1 << b;
+                    }
+                }
+                strip[p * stripWidth + c] = bits;
+            }
+        }
+    }
+    
+    // Copies w strip columns starting at srcX to screen column dstX
+    void blitWindow(Adafruit_SSD1306& display, int16_t dstX, int16_t srcX, int16_t w) {
+        if ((PANEL_ROTATION & 1) == 0) {
+            PageBitmap::blit(display, dstX, y, w, height, strip + srcX, stripWidth);
+            return;
+        }
+        // Transposed panels don't share the page layout
+        int16_t rowOffset = y & 7;
+        for (int16_t c = 0; c < w; c++) {
+            for (int16_t r = 0; r < height; r++) {
+                int16_t row = rowOffset + r;
+                bool on = strip[(row / 8) * stripWidth + srcX + c] & (1 << (row & 7));
+                display.drawPixel(dstX + c, y + r, on ? WHITE : BLACK);
+            }
+        }
+    }
+    
+public:
+    MarqueeLabel(int16_t x, int16_t y, int16_t w, int16_t h, const String& text, uint16_t speed = 25)
+        : Widget(x, y, w, h), text(text), speed(speed), strip(nullptr), stripWidth(0),
+          offset(0), startTime(0) {
+        render();
+    }
+    
+    ~MarqueeLabel() { free(strip); }
+    
+    MarqueeLabel(const MarqueeLabel&) = delete;
+    MarqueeLabel& operator=(const MarqueeLabel&) = delete;
+    
+    void setText(const String& newText) {
+        if (text != newText) {
+            text = newText;
+            render();
+            dirty = true;
+        }
+    }
+    
+    bool drawsIncrementally() const override { return true; }
+    
+    void update() override {
+        if (!strip) return;
+        int16_t newOffset = ((uint64_t)(millis() - startTime) * speed / 1000) % stripWidth;
+        if (newOffset != offset) {
+            offset = newOffset;
+            dirty = true;
+        }
+    }
+    
+    void draw(Adafruit_SSD1306& display) override {
+        if (strip) {
+            int16_t first = min<int16_t>(width, stripWidth - offset);
+            blitWindow(display, x, offset, first);
+            if (first < width) {
+                blitWindow(display, x + first, 0, width - first);
+            }
+            return;
+        }
+        
+        uint32_t id = RenderCache::hash(text.c_str());
+        if (renderCache.blit(display, this, id, x, y, width, height)) return;
+        
+        clear(display);
+        display.setTextColor(WHITE);
+        display.setCursor(x, y + (height - 8) / 2);
+        display.print(text);
+        renderCache.store(display, this, id, x, y, width, height);
+    }
+    
+    void handleInput(const InputEvent& event) override {}
+};
+
+// Icon widget
+class IconWidget : public Widget {
+private:
+    IconId icon;
+    
+public:
+    IconWidget(int16_t x, int16_t y, IconId icon = ICON_NONE)
+        : Widget(x, y, 8, 8), icon(icon) {}
+    
+    void setIcon(IconId newIcon) {
+        if (icon != newIcon) {
+            icon = newIcon;
+            dirty = true;
+        }
+    }
+    
+    void draw(Adafruit_SSD1306& display) override {
+        IconAtlas::draw(display, icon, x, y);
+    }
+    
+    void handleInput(const InputEvent& event) override {}
+    void update() override {}
+};
+
+// Status line: state icon and text, plus an activity icon (e.g. IR
+// traffic) at the right edge. Long texts scroll.
+class StatusLine : public Widget {
+private:
+    IconId icon;
+    IconId activityIcon;
+    bool active;
+    bool iconsChanged;
+    MarqueeLabel label;
+    
+    void drawIcon(Adafruit_SSD1306& display, IconId id, int16_t iconX) {
+        if (id == ICON_NONE) {
+            display.fillRect(iconX, y, 8, 8, BLACK);
+        } else {
+            IconAtlas::draw(display, id, iconX, y);
+        }
+    }
+    
+public:
+    StatusLine(int16_t x, int16_t y, int16_t w, int16_t h, const String& text, IconId activityIcon = ICON_IR)
+        : Widget(x, y, w, h), icon(ICON_NONE), activityIcon(activityIcon), active(false),
+          iconsChanged(true), label(x + 10, y, w - 20, h, text) {}
+    
+    void setStatus(IconId newIcon, const String& newText) {
+        if (icon != newIcon) {
+            icon = newIcon;
+            iconsChanged = true;
+        }
+        label.setText(newText);
+        dirty |= iconsChanged || label.isDirty();
+    }
+    
+    void setActivity(bool on) {
+        if (active != on) {
+            active = on;
+            iconsChanged = true;
+            dirty = true;
+        }
+    }
+    
+    bool drawsIncrementally() const override { return true; }
+    
+    void invalidate() override {
+        iconsChanged = true;
+        label.invalidate();
+        dirty = true;
+    }
+    
+    void update() override {
+        label.update();
+        dirty |= label.isDirty();
+    }
+    
+    void draw(Adafruit_SSD1306& display) override {
+        if (iconsChanged) {
+            drawIcon(display, icon, x);
+            drawIcon(display, active ? activityIcon : ICON_NONE, x + width - 8);
+            iconsChanged = false;
+        }
+        if (label.isDirty()) {
+            label.draw(display);
+            label.clearDirty();
+        }
+    }
+    
+    void handleInput(const InputEvent& event) override {}
+};
+
 // FloatDisplay widget
+// Number with a unit. Precision (decimals), Width (characters of the
+// number, sign and point included), the unit text and the deadband (in
+// counts of the last digit) are template arguments, so the scale factor
+// and every glyph position are compile-time constants. setValue() is a
+// multiply and an integer compare; draw() formats into a fixed-width
+// field and only redraws the characters that changed.
+template <uint8_t Precision, uint8_t Width, const char* Unit, uint8_t Deadband = 1>
 class FloatDisplay : public Widget {
+    static_assert(Width > Precision + (Precision ? 1 : 0), "Width must fit the decimals");
+    static_assert(Width <= 12, "Width is limited to 12 characters");
+    
 private:
-    float value;
-    int precision;
-    const char* units;
+    static constexpr int32_t pow10(uint8_t n) { return n == 0 ? 1 : 10 * pow10(n - 1); }
+    static constexpr float SCALE = pow10(Precision);
+    static constexpr int16_t CHAR_W = 6;
+    static constexpr int16_t UNIT_OFFSET = (Width + 1) * CHAR_W;
+    
+    int32_t scaled;          // Value in counts of the last digit
+    char shown[Width];       // Characters on screen
+    bool shownValid;
+    
+    // Right-aligned fixed-width rendering of scaled; dashes if it won't fit
+    static void format(int32_t value, char* out) {
+        uint32_t v = value < 0 ? -value : value;
+        int8_t pos = Width;
+        bool fits = false;
+        for (uint8_t d = 0; ; d++) {
+            if (Precision > 0 && d == Precision) {
+                if (--pos < 0) break;
+                out[pos] = '.';
+            }
+            if (--pos < 0) break;
+            out[pos] = '0' + v % 10;
+            v /= 10;
+            if (v == 0 && d >= Precision) {
+                fits = true;
+                break;
+            }
+        }
+        if (fits && value < 0) {
+            fits = --pos >= 0;
+            if (fits) out[pos] = '-';
+        }
+        if (!fits) {
+            memset(out, '-', Width);
+            return;
+        }
+        memset(out, ' ', pos);
+    }
     
 public:
-    FloatDisplay(int16_t x, int16_t y, int16_t w, int16_t h, int precision, const char* units)
-        : Widget(x, y, w, h), value(0), precision(precision), units(units) {}
+    FloatDisplay(int16_t x, int16_t y, int16_t w, int16_t h)
+        : Widget(x, y, w, h), scaled(0), shownValid(false) {}
     
     void setValue(float newValue) {
-        if (value != newValue) {
-            value = newValue;
+        int32_t s = lroundf(newValue * SCALE);
+        if (abs(s - scaled) >= Deadband) {
+            scaled = s;
             dirty = true;
         }
     }
     
+    float getValue() const { return scaled / SCALE; }
+    
+    bool drawsIncrementally() const override { return true; }
+    
+    void invalidate() override {
+        shownValid = false;
+        dirty = true;
+    }
+    
     void draw(Adafruit_SSD1306& display) override {
-        display.setTextColor(WHITE);
-        display.setCursor(x, y);
-        display.print(value, precision);
-        display.print(" ");
-        display.print(units);
+        if (!shownValid) {
+            clear(display);
+            display.setTextColor(WHITE);
+            display.setCursor(x + UNIT_OFFSET, y);
+            display.print(Unit);
+            memset(shown, 0, sizeof(shown));
+            shownValid = true;
+        }
+        
+        char text[Width];
+        format(scaled, text);
+        for (uint8_t i = 0; i < Width; i++) {
+            if (text[i] != shown[i]) {
+                // Opaque glyph: the background colour overwrites the old one
+                display.drawChar(x + i * CHAR_W, y, text[i], WHITE, BLACK, 1);
+                shown[i] = text[i];
+            }
+        }
     }
     
     void handleInput(const InputEvent& event) override {}
@@ -277,15 +609,57 @@ public:
 };
 
 // BatteryWidget
+// The fill is rendered incrementally: only the columns between the old and
+// the new fill width are repainted. The voltage/current text is kept as a
+// small bitmap and XORed over the interior, so it reads black on the fill
+// and white on the empty part, and only the changed columns need it again.
 class BatteryWidget : public Widget {
 private:
     float totalVoltage;
     float current;
     float percentage;
+    char text[32];
+    int16_t fillWidth;
+    int16_t shownFill;         // Fill width on screen, -1 when nothing is drawn
+    int16_t shownTextWidth;    // Width of the text bitmap on screen
+    bool textChanged;
+    GFXcanvas1 textBitmap;
+    
+    int16_t interiorX() const { return x + 2; }
+    int16_t interiorY() const { return y + 4; }
+    int16_t interiorWidth() const { return width - 14; }
+    int16_t interiorHeight() const { return height - 8; }
+    int16_t textRow() const { return height / 2 - 8; }
+    
+    // Repaints interior columns [from, to) for the current fill and text
+    void repaintColumns(Adafruit_SSD1306& display, int16_t from, int16_t to) {
+        if (from >= to) return;
+        
+        int16_t split = constrain(fillWidth, from, to);
+        if (split > from) {
+            display.fillRect(interiorX() + from, interiorY(), split - from, interiorHeight(), WHITE);
+        }
+        if (to > split) {
+            display.fillRect(interiorX() + split, interiorY(), to - split, interiorHeight(), BLACK);
+        }
+        
+        int16_t textEnd = min<int16_t>(to, strlen(text) * 6);
+        for (int16_t cx = from; cx < textEnd; cx++) {
+            for (int16_t cy = 0; cy < 8; cy++) {
+                if (textBitmap.getPixel(cx, cy)) {
+                    display.drawPixel(interiorX() + cx, interiorY() + textRow() + cy, INVERSE);
+                }
+            }
+        }
+    }
     
 public:
     BatteryWidget(int16_t x, int16_t y, int16_t w, int16_t h)
-        : Widget(x, y, w, h), totalVoltage(0), current(0), percentage(0) {}
+        : Widget(x, y, w, h), totalVoltage(0), current(0), percentage(0),
+          fillWidth(0), shownFill(-1), shownTextWidth(0), textChanged(true),
+          textBitmap(w - 14, 8) {
+        text[0] = '\0';
+    }
     
     void updateValues(float voltage, float curr) {
         totalVoltage = voltage;
@@ -293,27 +667,217 @@ public:
         percentage = ((voltage/CELL_COUNT) - CELL_VOLTAGE_MIN) / 
                     (CELL_VOLTAGE_MAX - CELL_VOLTAGE_MIN) * 100;
         percentage = constrain(percentage, 0, 100);
+        
+        int16_t newFill = ((width - 14) * percentage) / 100;
+        char newText[sizeof(text)];
+        snprintf(newText, sizeof(newText), "%.2fV %.0fmA", totalVoltage, current);
+        
+        if (strcmp(newText, text) != 0) {
+            strcpy(text, newText);
+            textChanged = true;
+            dirty = true;
+        }
+        if (newFill != fillWidth) {
+            fillWidth = newFill;
+            dirty = true;
+        }
+    }
+    
+    bool drawsIncrementally() const override { return true; }
+    
+    void invalidate() override {
+        shownFill = -1;
         dirty = true;
     }
     
     void draw(Adafruit_SSD1306& display) override {
-        display.drawRect(x, y + 2, width - 10, height - 4, WHITE);
-        display.fillRect(x + width - 10, y + height/3, 10, height/3, WHITE);
+        if (textChanged) {
+            textBitmap.fillScreen(0);
+            textBitmap.setCursor(0, 0);
+            textBitmap.setTextColor(1);
+            textBitmap.print(text);
+        }
         
-        int fillWidth = ((width - 14) * percentage) / 100;
-        display.fillRect(x + 2, y + 4, fillWidth, height - 8, WHITE);
+        if (shownFill < 0) {
+            clear(display);
+            display.drawRect(x, y + 2, width - 10, height - 4, WHITE);
+            display.fillRect(x + width - 10, y + height/3, 10, height/3, WHITE);
+            repaintColumns(display, 0, interiorWidth());
+        } else {
+            // Columns where the fill edge moved
+            repaintColumns(display, min(shownFill, fillWidth), max(shownFill, fillWidth));
+            
+            // Columns covered by the old or the new text, minus the ones above
+            if (textChanged) {
+                int16_t textWidth = max<int16_t>(shownTextWidth, strlen(text) * 6);
+                textWidth = min(textWidth, interiorWidth());
+                int16_t lo = min(shownFill, fillWidth), hi = max(shownFill, fillWidth);
+                repaintColumns(display, 0, min(textWidth, lo));
+                repaintColumns(display, max<int16_t>(hi, 0), textWidth);
+            }
+        }
         
-        char buffer[32];
-        snprintf(buffer, sizeof(buffer), "%.2fV %.0fmA", totalVoltage, current);
-        display.setCursor(x + 2, y + height/2 - 4);
-        display.setTextColor(percentage > 50 ? BLACK : WHITE);
-        display.print(buffer);
+        shownFill = fillWidth;
+        shownTextWidth = strlen(text) * 6;
+        textChanged = false;
     }
     
     void handleInput(const InputEvent& event) override {}
     void update() override {}
 };
 
+// TableWidget
+// Grid of cells with fixed column widths. Each cell holds either a fixed
+// text or a formatter that is polled on update(); a cell is marked dirty
+// only when its formatted text changes. The grid lines and fixed texts
+// are drawn once when the table is shown, after that a draw only clears
+// and reprints the text area of the dirty cells.
+class TableWidget : public Widget {
+public:
+    typedef std::function<void(char* buf, size_t size)> CellFormatter;
+    
+    struct Column {
+        int16_t width;
+        bool alignRight;
+    };
+    
+    // Formatter for a numeric source, e.g. number(getVolts, 2, "V")
+    static CellFormatter number(std::function<float()> source, uint8_t precision, const char* unit = "") {
+        return [source, precision, unit](char* buf, size_t size) {
+            snprintf(buf, size, "%.*f%s", precision, source(), unit);
+        };
+    }
+    
+private:
+    static const uint8_t CELL_CHARS = 16;
+    
+    struct Cell {
+        CellFormatter formatter;
+        char text[CELL_CHARS + 1];
+    };
+    
+    uint8_t rows;
+    std::vector<Column> columns;
+    std::vector<int16_t> columnX;      // Left edge of each column
+    std::vector<Cell> cells;
+    std::vector<uint32_t> dirtyCells;  // One bit per cell
+    int16_t rowHeight;
+    bool gridShown;
+    
+    Cell& cell(uint8_t row, uint8_t col) { return cells[row * columns.size() + col]; }
+    
+    void setCellDirty(size_t index) {
+        dirtyCells[index / 32] |= 1UL << (index % 32);
+        dirty = true;
+    }
+    
+    bool takeCellDirty(size_t index) {
+        uint32_t bit = 1UL << (index % 32);
+        bool wasDirty = dirtyCells[index / 32] & bit;
+        dirtyCells[index / 32] &= ~bit;
+        return wasDirty;
+    }
+    
+    void storeText(size_t index, const char* text) {
+        Cell& c = cells[index];
+        if (strncmp(c.text, text, CELL_CHARS) != 0) {
+            strncpy(c.text, text, CELL_CHARS);
+            c.text[CELL_CHARS] = '\0';
+            setCellDirty(index);
+        }
+    }
+    
+    void drawGrid(Adafruit_SSD1306& display) {
+        display.drawRect(x, y, width, rows * rowHeight + 1, WHITE);
+        for (uint8_t r = 1; r < rows; r++) {
+            display.drawFastHLine(x, y + r * rowHeight, width, WHITE);
+        }
+        for (size_t c = 1; c < columns.size(); c++) {
+            display.drawFastVLine(columnX[c], y, rows * rowHeight + 1, WHITE);
+        }
+    }
+    
+    void drawCell(Adafruit_SSD1306& display, uint8_t row, uint8_t col) {
+        // Text area inside the grid lines
+        int16_t right = col + 1 < columns.size() ? columnX[col + 1] : x + width - 1;
+        int16_t cx = columnX[col] + 1;
+        int16_t cy = y + row * rowHeight + 1;
+        int16_t cw = right - cx;
+        int16_t ch = rowHeight - 1;
+        display.fillRect(cx, cy, cw, ch, BLACK);
+        
+        const char* text = cell(row, col).text;
+        int16_t maxChars = (cw - 2) / 6;
+        int16_t chars = min<int16_t>(strlen(text), maxChars);
+        int16_t tx = columns[col].alignRight ? cx + cw - 1 - chars * 6 : cx + 1;
+        
+        display.setTextColor(WHITE);
+        display.setCursor(tx, cy + (ch - 8) / 2);
+        for (int16_t i = 0; i < chars; i++) {
+            display.write(text[i]);
+        }
+    }
+    
+public:
+    // Row height is h / rows; column widths should add up to w
+    TableWidget(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t rows, std::initializer_list<Column> cols)
+        : Widget(x, y, w, h), rows(rows), columns(cols), rowHeight(h / rows), gridShown(false) {
+        int16_t left = x;
+        for (const Column& c : columns) {
+            columnX.push_back(left);
+            left += c.width;
+        }
+        cells.resize(rows * columns.size());
+        for (auto& c : cells) c.text[0] = '\0';
+        dirtyCells.assign((cells.size() + 31) / 32, 0);
+    }
+    
+    void setText(uint8_t row, uint8_t col, const char* text) {
+        if (row >= rows || col >= columns.size()) return;
+        cell(row, col).formatter = nullptr;
+        storeText(row * columns.size() + col, text);
+    }
+    
+    void setFormatter(uint8_t row, uint8_t col, CellFormatter formatter) {
+        if (row >= rows || col >= columns.size()) return;
+        cell(row, col).formatter = formatter;
+    }
+    
+    bool drawsIncrementally() const override { return true; }
+    
+    void invalidate() override {
+        gridShown = false;
+        dirty = true;
+    }
+    
+    void update() override {
+        char buf[CELL_CHARS + 1];
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (cells[i].formatter) {
+                cells[i].formatter(buf, sizeof(buf));
+                storeText(i, buf);
+            }
+        }
+    }
+    
+    void draw(Adafruit_SSD1306& display) override {
+        bool all = !gridShown;
+        if (all) {
+            clear(display);
+            drawGrid(display);
+            gridShown = true;
+        }
+        
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (takeCellDirty(i) || all) {
+                drawCell(display, i / columns.size(), i % columns.size());
+            }
+        }
+    }
+    
+    void handleInput(const InputEvent& event) override {}
+};
+
 // FunctionPlotter widget
 class FunctionPlotter : public Widget {
 private:
@@ -384,7 +948,7 @@ public:
 // UIManager class
 class UIManager {
 private:
-    Adafruit_SSD1306 display;
+    OrientedSSD1306<PANEL_ROTATION> display;
     IRrecv irReceiver;
     std::vector<Screen*> screens;
     ScreenType currentScreenType;
@@ -428,6 +992,7 @@ public:
         if (type < screens.size() && screens[type]) {
             currentScreenType = type;
             display.clearDisplay();
+            screens[type]->invalidate();
         }
     }
     
@@ -451,7 +1016,7 @@ public:
         currentScreen->handleInput(event);
         currentScreen->update();
         
-        display.clearDisplay();
+        // Widgets clear or patch their own area; the frame is only wiped on setScreen()
         currentScreen->draw(display);
         display.display();
     }
@@ -14,6 +14,22 @@ float capacityMah = 0.0f;
 unsigned long chargeStartTime = 0;
 bool charging = false;
 GraphType currentGraph = VOLTAGE_GRAPH;
+unsigned long lastIRActivity = 0;
+
+// How long the IR icon stays lit after a key press
+const unsigned long IR_ACTIVITY_MS = 300;
+
+// Show the temperature icon this close to the cut-off
+const float TEMP_WARNING_MARGIN = 5.0f;
+
+// Battery temperature when charging was cut off, for the status line
+float tripTemperature = 0.0f;
+
+// Main screen readouts; 0.2 C deadband keeps ADC noise off the display
+constexpr char UNIT_TEMP[] = "Temp C";
+constexpr char UNIT_MAH[] = "mAh";
+typedef FloatDisplay<1, 5, UNIT_TEMP, 2> TempDisplay;
+typedef FloatDisplay<0, 5, UNIT_MAH> CapacityDisplay;
 
 // History buffers for graphs
 const int GRAPH_HISTORY_SIZE = 128;
@@ -114,6 +130,27 @@ const char* getStateString() {
     }
 }
 
+const char* getShortStateString() {
+    switch(chargerState) {
+        case IDLE: return "Idle";
+        case CHARGING: return "Fast";
+        case TRICKLE: return "Trickle";
+        case COMPLETE: return "Done";
+        case ERROR: return "Overtemp";
+        default: return "?";
+    }
+}
+
+IconId getStateIcon() {
+    switch(chargerState) {
+        case CHARGING: return ICON_CHARGING;
+        case TRICKLE: return ICON_TRICKLE;
+        case COMPLETE: return ICON_COMPLETE;
+        case ERROR: return ICON_ERROR;
+        default: return ICON_NONE;
+    }
+}
+
 void updateHistory() {
     unsigned long currentTime = millis();
     if(currentTime - lastHistoryUpdate >= 1000) {
@@ -245,8 +282,9 @@ void updateCharging() {
             switch(chargerState) {
                 case CHARGING:
                     if(temperature > MAX_TEMP || checkTemperatureTermination()) {
-                        chargerState = ERROR;
+                        tripTemperature = temperature;
                         stopCharging();
+                        chargerState = ERROR;   // Latched until the next start
                     } else if(detectMinusAV()) {
                         chargerState = TRICKLE;
                         setPWMDutyCycle(TRICKLE_CURRENT_MA);
@@ -257,8 +295,8 @@ void updateCharging() {
                     
                 case TRICKLE:
                     if(capacityMah >= CAPACITY_MAH) {
-                        chargerState = COMPLETE;
                         stopCharging();
+                        chargerState = COMPLETE;   // Latched until the next start
                     }
                     break;
                     
@@ -275,6 +313,22 @@ void updateCharging() {
             capacityMah += (chargeCurrent * 0.1f) / 3600.0f;
         }
         
+        // Main screen readouts
+        ((BatteryWidget*)mainScreen->getWidget(1))->updateValues(batteryVoltage, chargeCurrent);
+        ((TempDisplay*)mainScreen->getWidget(2))->setValue(temperature);
+        ((CapacityDisplay*)mainScreen->getWidget(3))->setValue(capacityMah);
+        
+        // Status icons
+        auto* status = (StatusLine*)mainScreen->getWidget(0);
+        String statusText = getStateString();
+        if(chargerState == ERROR) {
+            statusText += " at " + String(tripTemperature, 1) + "C";
+        }
+        status->setStatus(getStateIcon(), statusText);
+        status->setActivity(currentTime - lastIRActivity < IR_ACTIVITY_MS);
+        ((IconWidget*)mainScreen->getWidget(5))->setIcon(
+            temperature > MAX_TEMP - TEMP_WARNING_MARGIN ? ICON_TEMPERATURE : ICON_NONE);
+        
         // Update UI for current screen
         auto* currentScreen = ui.getScreen(ui.getCurrentScreenType());
         if(currentScreen) {
@@ -285,6 +339,7 @@ void updateCharging() {
 
 void handleIRInput(const InputEvent& event) {
     if(event.type == InputEvent::IR_BUTTON) {
+        lastIRActivity = millis();
         switch(event.value) {
             case IR_RED:
                 ui.setScreen(MAIN_SCREEN);
@@ -295,6 +350,8 @@ void handleIRInput(const InputEvent& event) {
             case IR_BLUE:
                 if(ui.getCurrentScreenType() == GRAPH_SCREEN) {
                     currentGraph = (GraphType)((currentGraph + 1) % 3);
+                } else {
+                    ui.setScreen(STATS_SCREEN);
                 }
                 break;
         }
@@ -317,18 +374,39 @@ void setup() {
     
     // Create main screen
     mainScreen = new Screen();
-    mainScreen->addWidget(new Label(0, 0, 128, 10, "NiMH Charger", true));
+    mainScreen->addWidget(new StatusLine(0, 0, 128, 10, "NiMH Charger"));
     mainScreen->addWidget(new BatteryWidget(0, 12, 128, 20));
-    mainScreen->addWidget(new FloatDisplay(0, 34, 128, 10, 1, "Temp C"));
-    mainScreen->addWidget(new FloatDisplay(0, 44, 128, 10, 0, "mAh"));
+    mainScreen->addWidget(new TempDisplay(0, 34, 128, 10));
+    mainScreen->addWidget(new CapacityDisplay(0, 44, 128, 10));
     mainScreen->addWidget(new Button(14, 54, 100, 10, "Start Charging", startCharging));
+    mainScreen->addWidget(new IconWidget(120, 34));
     
     // Create graph screen
     auto* graphScreen = new GraphScreen();
     
+    // Create stats screen: one table instead of a widget per value
+    auto* statsScreen = new Screen();
+    auto* stats = new TableWidget(0, 0, 128, 61, 6, { { 50, false }, { 78, true } });
+    const char* names[] = { "Voltage", "Current", "Power", "Charged", "Temp", "State" };
+    for(uint8_t row = 0; row < 6; row++) {
+        stats->setText(row, 0, names[row]);
+    }
+    stats->setFormatter(0, 1, TableWidget::number([]() { return batteryVoltage; }, 2, "V"));
+    stats->setFormatter(1, 1, TableWidget::number([]() { return chargeCurrent; }, 2, "A"));
+    stats->setFormatter(2, 1, TableWidget::number([]() { return batteryVoltage * chargeCurrent; }, 1, "W"));
+    stats->setFormatter(3, 1, TableWidget::number([]() { return capacityMah; }, 0, "mAh"));
+    stats->setFormatter(4, 1, [](char* buf, size_t size) {
+        snprintf(buf, size, "%.1fC %+.1f", temperature, temperature - ambientTemperature);
+    });
+    stats->setFormatter(5, 1, [](char* buf, size_t size) {
+        snprintf(buf, size, "%s", getShortStateString());
+    });
+    statsScreen->addWidget(stats);
+    
     // Initialize screens in UI manager
     ui.addScreen(MAIN_SCREEN, mainScreen);
     ui.addScreen(GRAPH_SCREEN, graphScreen);
+    ui.addScreen(STATS_SCREEN, statsScreen);
     ui.setScreen(MAIN_SCREEN);
 }
 
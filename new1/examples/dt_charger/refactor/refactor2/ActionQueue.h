@@ -0,0 +1,78 @@
+#ifndef ACTION_QUEUE_H
+#define ACTION_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Things input handlers ask the control loop to do
+enum class ActionType : uint8_t {
+    SHOW_SCREEN,      // arg: screen index
+    TOGGLE_CHARGING,
+    NEXT_GRAPH
+};
+
+struct Action {
+    ActionType type;
+    uint32_t arg;
+};
+
+// Bounded lock-free queue of actions. Button and IR handlers only post
+// (a copy and an index bump); the control loop drains the queue at one
+// defined point, outside of input handling and drawing, so handlers never
+// run heavy work mid-frame or change screens while they are iterated.
+// Safe for one producer and one consumer, e.g. an input task or ISR
+// posting and loop() draining.
+template <size_t CAPACITY>
+class ActionQueue {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+private:
+    Action slots[CAPACITY];
+    std::atomic<uint32_t> head{0};     // Next slot to read, owned by the consumer
+    std::atomic<uint32_t> tail{0};     // Next slot to write, owned by the producer
+    std::atomic<uint32_t> droppedCount{0};
+
+public:
+    // Returns false (and counts a drop) if the queue is full
+    bool post(ActionType type, uint32_t arg = 0) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) >= CAPACITY) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[t & (CAPACITY - 1)] = { type, arg };
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool post(const Action& action) { return post(action.type, action.arg); }
+
+    bool pop(Action& out) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        out = slots[h & (CAPACITY - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Applies at most maxActions queued actions; ones posted meanwhile wait
+    // for the next drain
+    template <typename Handler>
+    size_t drain(Handler handler, size_t maxActions = CAPACITY) {
+        size_t n = 0;
+        Action action;
+        while (n < maxActions && pop(action)) {
+            handler(action);
+            n++;
+        }
+        return n;
+    }
+
+    uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+};
+
+constexpr size_t ACTION_QUEUE_SIZE = 16;
+
+inline ActionQueue<ACTION_QUEUE_SIZE> actionQueue;
+
+#endif // ACTION_QUEUE_H
@@ -7,10 +7,9 @@ class GraphScreen : public Screen {
 public:
     GraphScreen() {
         addWidget(new Label(0, 0, SCREEN_WIDTH, "Voltage Graph", true));
-        addWidget(new Button(14, 54, 100, "Next Graph", []() { cycleGraphType(); }));
+        addWidget(new Button(14, 54, 100, "Next Graph", { ActionType::NEXT_GRAPH, 0 }));
     }
 
-private:
     void cycleGraphType() {
         // Logic to cycle graph types
     }
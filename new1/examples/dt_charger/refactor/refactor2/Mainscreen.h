@@ -8,7 +8,7 @@ public:
     MainScreen() {
         addWidget(new Label(0, 0, SCREEN_WIDTH, "NiMH Charger", true));
         addWidget(new Label(0, 12, SCREEN_WIDTH, "Status: Idle"));
-        addWidget(new Button(14, 54, 100, "Start Charging", []() { startCharging(); }));
+        addWidget(new Button(14, 54, 100, "Start Charging", { ActionType::TOGGLE_CHARGING, 0 }));
     }
 };
 
@@ -7,6 +7,7 @@
 #include <vector>
 #include <functional>
 #include "IR_CommandManager.h"
+#include "ActionQueue.h"
 
 // Display Settings
 constexpr uint8_t SCREEN_WIDTH = 128;
@@ -71,14 +72,16 @@ public:
 };
 
 // Button Widget
+// Pressing posts the button's action; the work happens when the control
+// loop drains the action queue.
 class Button : public Widget {
 private:
     String label;
-    std::function<void()> callback;
+    Action action;
 
 public:
-    Button(int16_t x, int16_t y, int16_t width, const String& label, std::function<void()> callback)
-        : Widget(x, y, width, 10), label(label), callback(callback) {}
+    Button(int16_t x, int16_t y, int16_t width, const String& label, Action action)
+        : Widget(x, y, width, 10), label(label), action(action) {}
 
     void draw(Adafruit_SSD1306& display) override {
         display.drawRect(x, y, width, height, WHITE);
@@ -94,7 +97,7 @@ public:
 
     void handleInput(uint32_t irCode) override {
         if (focused && irCode == IRCodes::OK) {
-            if (callback) callback();
+            actionQueue.post(action);
         }
     }
 };
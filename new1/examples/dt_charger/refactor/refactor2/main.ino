@@ -3,6 +3,31 @@
 #include "GraphScreen.h"
 
 UIManager ui;
+GraphScreen* graphScreen;
+bool charging = false;
+
+// Placeholder: this sketch is the UI framework alone, with no charger
+// behind it, so the button only flips a flag and logs. refactor3 routes
+// its button through the same kind of queue to ChargerController.
+void toggleCharging() {
+    charging = !charging;
+    Serial.println(charging ? "Charging started (placeholder)" : "Charging stopped (placeholder)");
+}
+
+// Runs queued actions from buttons and IR commands
+void applyAction(const Action& action) {
+    switch (action.type) {
+        case ActionType::SHOW_SCREEN:
+            ui.setScreen(action.arg);
+            break;
+        case ActionType::TOGGLE_CHARGING:
+            toggleCharging();
+            break;
+        case ActionType::NEXT_GRAPH:
+            graphScreen->cycleGraphType();
+            break;
+    }
+}
 
 void setup() {
     Serial.begin(115200);
@@ -13,15 +38,19 @@ void setup() {
     }
 
     ui.addScreen(new MainScreen());
-    ui.addScreen(new GraphScreen());
+    graphScreen = new GraphScreen();
+    ui.addScreen(graphScreen);
     ui.setScreen(0);
 
     auto& irManager = ui.getIRManager();
-    irManager.addCommand(IRCodes::RED, []() { ui.setScreen(0); }, "Main Screen");
-    irManager.addCommand(IRCodes::GREEN, []() { ui.setScreen(1); }, "Graph Screen");
+    irManager.addCommand(IRCodes::RED, []() { actionQueue.post(ActionType::SHOW_SCREEN, 0); }, "Main Screen");
+    irManager.addCommand(IRCodes::GREEN, []() { actionQueue.post(ActionType::SHOW_SCREEN, 1); }, "Graph Screen");
     irManager.printCommands();
 }
 
 void loop() {
     ui.update();
+
+    // Input handlers only queue actions; apply them between frames
+    actionQueue.drain(applyAction);
 }
@@ -2,6 +2,9 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 namespace Config {
     // Display settings
     constexpr int SCREEN_WIDTH = 128;
@@ -16,6 +19,7 @@ namespace Config {
     constexpr int TEMP_PIN = 34;
     constexpr int AMBIENT_TEMP_PIN = 35;
     constexpr int PWM_PIN = 25;
+    constexpr int POWER_MONITOR_ALERT_PIN = 32;
 
     // Battery parameters
     constexpr int CELL_COUNT = 4;
@@ -29,19 +33,133 @@ namespace Config {
     constexpr float DT_THRESHOLD = 2.0f;
     constexpr float MAX_DT_RATE = 1.0f;
     constexpr float MAX_TEMP = 45.0f;
-
-    // Update intervals
-    constexpr unsigned long UI_UPDATE_INTERVAL = 50;
-    constexpr unsigned long SENSOR_UPDATE_INTERVAL = 100;
-    constexpr unsigned long HISTORY_UPDATE_INTERVAL = 1000;
+    constexpr float MIN_SENSOR_TEMP = -20.0f;     // Colder readings mean an open thermistor
+
+    // Safety interlock
+    constexpr float MAX_CHARGE_CURRENT = 1.5f;    // Amps, as SensorManager reports it
+    constexpr uint32_t INTERLOCK_SAMPLE_HZ = 2000;
+    constexpr uint8_t INTERLOCK_TRIP_SAMPLES = 2; // Consecutive samples past a limit
+    constexpr uint32_t INTERLOCK_MAX_LATENCY_US = 1500;
+
+    // INA226 on the I2C bus for battery voltage and current; the interlock
+    // keeps using the ESP32's own ADC
+    constexpr bool USE_POWER_MONITOR = true;
+    constexpr uint8_t POWER_MONITOR_ADDRESS = 0x40;
+    constexpr float SHUNT_OHMS = 0.05f;
+    constexpr uint64_t POWER_MONITOR_DEADLINE_US = 500;
+
+    // Memory budgets; crossing one prints a report on Serial
+    constexpr uint32_t SCREEN_HEAP_BUDGET_BYTES = 96 * 1024;
+    constexpr uint32_t MIN_LARGEST_FREE_BLOCK = 16 * 1024;   // Fragmentation floor
+    constexpr uint32_t LOOP_STACK_MIN_FREE = 1024;
+    constexpr uint32_t INTERLOCK_STACK_MIN_FREE = 512;
+
+    // Update intervals (microseconds)
+    constexpr uint64_t UI_UPDATE_INTERVAL_US = 50000;
+    constexpr uint64_t SENSOR_UPDATE_INTERVAL_US = 100000;
+    constexpr uint64_t HISTORY_UPDATE_INTERVAL_US = 1000000;
+    constexpr uint64_t TEMP_CHECK_INTERVAL_US = 60000000;
+    constexpr uint64_t IR_REPEAT_DELAY_US = 250000;
+
+    // Button actions waiting for loop(); more presses than this are dropped
+    constexpr size_t ACTION_QUEUE_SIZE = 16;
 }
 
 #endif // CONFIG_H
 
+// clock.h
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+
+// Time source shared by every subsystem, in microseconds since boot.
+// 64 bits don't wrap in any realistic uptime, unlike millis() after 49 days.
+class Clock {
+public:
+    virtual ~Clock() = default;
+    virtual uint64_t nowUs() const = 0;
+
+    // Tells the clock the caller has nothing to do before atUs. Real time
+    // ignores it; a virtual clock uses it to skip over idle stretches.
+    virtual void wakeAt(uint64_t) {}
+};
+
+#ifdef ARDUINO
+#include <esp_timer.h>
+
+class HardwareClock : public Clock {
+public:
+    uint64_t nowUs() const override { return (uint64_t)esp_timer_get_time(); }
+};
+#endif
+
+// Host clock that only moves when told to. Each loop pass collects the
+// earliest deadline the subsystems asked for, and advanceToNextDeadline()
+// jumps straight there, so a simulated month of charging costs one loop
+// pass per event instead of one per millisecond.
+class VirtualClock : public Clock {
+public:
+    static constexpr uint64_t NO_DEADLINE = UINT64_MAX;
+
+    uint64_t nowUs() const override { return now; }
+
+    void wakeAt(uint64_t atUs) override {
+        if (atUs < nextDeadline) nextDeadline = atUs;
+    }
+
+    void advance(uint64_t us) { advanceTo(now + us); }
+
+    // Deadlines are re-reported on every poll, so they're forgotten here
+    void advanceTo(uint64_t atUs) {
+        if (atUs > now) now = atUs;
+        nextDeadline = NO_DEADLINE;
+    }
+
+    // False if nothing asked to be woken since the last advance
+    bool advanceToNextDeadline() {
+        if (nextDeadline == NO_DEADLINE) return false;
+        advanceTo(nextDeadline);
+        return true;
+    }
+
+private:
+    uint64_t now = 0;
+    uint64_t nextDeadline = NO_DEADLINE;
+};
+
+// Fires at most once per period, restarting the period when it fires.
+// Every poll reports the next due time to the clock.
+class PeriodicTimer {
+public:
+    explicit PeriodicTimer(uint64_t periodUs) : period(periodUs), last(0) {}
+
+    bool due(Clock& clock) {
+        uint64_t now = clock.nowUs();
+        bool fire = now - last >= period;
+        if (fire) last = now;
+        clock.wakeAt(last + period);
+        return fire;
+    }
+
+    uint64_t lastFiredUs() const { return last; }
+
+private:
+    uint64_t period;
+    uint64_t last;
+};
+
+#endif // CLOCK_H
+
 // sensor_manager.h
 #ifndef SENSOR_MANAGER_H
 #define SENSOR_MANAGER_H
 
+#include <math.h>
+#include <stdint.h>
+
+class PowerMonitor;
+
 class SensorManager {
 public:
     struct SensorData {
@@ -53,7 +171,35 @@ public:
 
     static SensorData readSensors();
 
+    // Takes battery voltage and current from an external monitor's latest
+    // conversion instead of the internal ADC; nullptr switches back
+    static void usePowerMonitor(const PowerMonitor* monitor) { powerMonitor = monitor; }
+
+    // Inverses of the read conversions, in ADC counts. Limits are turned
+    // into counts once so per-sample checks compare integers.
+    static uint16_t temperatureToRaw(float celsius) {
+        float resistance = R25 * expf(BETA * (1.0f / (celsius + 273.15f) - 1.0f / (25.0f + 273.15f)));
+        return toRaw(ADC_MAX * R_SERIES / (resistance + R_SERIES));
+    }
+
+    static uint16_t currentToRaw(float current) {
+        return toRaw(current * CURRENT_SENSE_FACTOR / ADC_REFERENCE * ADC_MAX);
+    }
+
 private:
+    static constexpr float ADC_MAX = 4095.0f;
+    static constexpr float ADC_REFERENCE = 3.3f;
+    static constexpr float CURRENT_SENSE_FACTOR = 0.1f;
+    static constexpr float BETA = 3950.0f;
+    static constexpr float R25 = 10000.0f;
+    static constexpr float R_SERIES = 10000.0f;
+
+    static const PowerMonitor* powerMonitor;
+
+    static uint16_t toRaw(float counts) {
+        return counts <= 0.0f ? 0 : counts >= ADC_MAX ? (uint16_t)ADC_MAX : (uint16_t)lroundf(counts);
+    }
+
     static float readBatteryVoltage();
     static float readChargeCurrent();
     static float readTemperature(int pin);
@@ -66,12 +212,15 @@ private:
 #define HISTORY_MANAGER_H
 
 #include <vector>
+#include "config.h"
+#include "clock.h"
+#include "sensor_manager.h"
 
 struct HistoryPoint {
     float voltage;
     float current;
     float tempDelta;
-    unsigned long timestamp;
+    uint64_t timestampUs;
 };
 
 class HistoryManager {
@@ -79,11 +228,16 @@ public:
     static constexpr int HISTORY_SIZE = 128;
     static constexpr int VOLTAGE_HISTORY_SIZE = 60;
 
+    explicit HistoryManager(Clock& clock)
+        : clock(clock), updateTimer(Config::HISTORY_UPDATE_INTERVAL_US) {}
+
     void addPoint(const SensorManager::SensorData& data);
     bool detectMinusAV() const;
     std::vector<HistoryPoint> getVisibleHistory() const;
     
 private:
+    Clock& clock;
+    PeriodicTimer updateTimer;
     HistoryPoint history[HISTORY_SIZE];
     float voltageHistory[VOLTAGE_HISTORY_SIZE];
     int historyIndex = 0;
@@ -96,6 +250,12 @@ private:
 #ifndef CHARGER_CONTROLLER_H
 #define CHARGER_CONTROLLER_H
 
+#include "config.h"
+#include "clock.h"
+#include "sensor_manager.h"
+#include "history_manager.h"
+#include "safety_interlock.h"
+
 enum class ChargerState {
     IDLE,
     CHARGING,
@@ -106,8 +266,14 @@ enum class ChargerState {
 
 class ChargerController {
 public:
+    ChargerController(Clock& clock, const HistoryManager& history, SafetyInterlock& interlock)
+        : clock(clock), history(history), interlock(interlock),
+          tempCheckTimer(Config::TEMP_CHECK_INTERVAL_US) {}
+
     void begin();
-    void update();
+    void update(const SensorManager::SensorData& data);
+    // Also clears an interlock trip if every limit is back in range, so a
+    // fault that has gone away doesn't need a reboot
     void startCharging();
     void stopCharging();
     
@@ -117,25 +283,62 @@ public:
     bool isCharging() const { return charging; }
 
 private:
+    Clock& clock;
+    const HistoryManager& history;
+    SafetyInterlock& interlock;
+    uint32_t lastInterlockSamples = 0;
     ChargerState state = ChargerState::IDLE;
     float capacityMah = 0.0f;
     bool charging = false;
-    unsigned long chargeStartTime = 0;
-
-    void setPWMDutyCycle(float targetCurrentMA);
+    uint64_t chargeStartUs = 0;
+    uint64_t lastCapacityUs = 0;
+    PeriodicTimer tempCheckTimer;
+    float lastTempDelta = 0.0f;
+    const char* errorText = "";     // Why ERROR was entered, for getStateString()
+
+    void fail(const char* why);
+    void setPWMDutyCycle(float targetCurrentMA, float measuredCurrentMA);
     bool checkTemperatureTermination(const SensorManager::SensorData& data);
     void updateCapacity(float current);
 };
 
 #endif // CHARGER_CONTROLLER_H
 
+// ir_codes.h
+#ifndef IR_CODES_H
+#define IR_CODES_H
+
+#include <functional>
+#include <stdint.h>
+
+// Remote key codes
+namespace IRCodes {
+    constexpr uint32_t UP = 0x18;
+    constexpr uint32_t DOWN = 0x52;
+    constexpr uint32_t LEFT = 0x08;
+    constexpr uint32_t RIGHT = 0x5A;
+    constexpr uint32_t OK = 0x1C;
+    constexpr uint32_t RED = 0x45;
+    constexpr uint32_t GREEN = 0x46;
+    constexpr uint32_t BLUE = 0x47;
+}
+
+// A key as IRManager hands it to screens and widgets
+struct IRCommand {
+    uint32_t code;
+    std::function<void()> handler;
+    const char* description;
+};
+
+#endif // IR_CODES_H
+
 // ui_components.h
 #ifndef UI_COMPONENTS_H
 #define UI_COMPONENTS_H
 
 #include <functional>
 #include "Adafruit_GFX.h"
-#include "Adafruit_SSD1306.h"
+#include "ir_codes.h"
 
 class Widget {
 protected:
@@ -147,7 +350,9 @@ public:
     Widget(int16_t x, int16_t y, int16_t w, int16_t h);
     virtual ~Widget() = default;
     
-    virtual void draw(Adafruit_SSD1306& display) = 0;
+    // Any GFX target: the SSD1306, or a LinuxFramebuffer (linux_framebuffer.h)
+    // with setMonochrome() on SBC builds
+    virtual void draw(Adafruit_GFX& display) = 0;
     virtual void handleInput(const IRCommand& cmd) = 0;
     virtual void update() = 0;
     
@@ -169,42 +374,35 @@ public:
 #include <vector>
 #include <functional>
 #include "IRremote.h"
-
-struct IRCommand {
-    uint32_t code;
-    std::function<void()> handler;
-    const char* description;
-};
+#include "clock.h"
+#include "ir_codes.h"
 
 class IRManager {
 public:
+    explicit IRManager(Clock& clock) : clock(clock) {}
+
     void begin(int pin);
     void update();
     void addCommand(uint32_t code, std::function<void()> handler, const char* description);
     const std::vector<IRCommand>& getCommands() const;
 
 private:
+    Clock& clock;
     IRrecv receiver;
     std::vector<IRCommand> commands;
     uint32_t lastCode = 0;
-    unsigned long lastCommandTime = 0;
-    
-    static constexpr unsigned long REPEAT_DELAY = 250;
+    uint64_t lastCommandUs = 0;
 };
 
 #endif // IR_MANAGER_H
 
 // main.cpp
 #include "config.h"
-#include "sensor_manager.h"
-#include "history_manager.h"
-#include "charger_controller.h"
-#include "ui_manager.h"
+#include "globals.h"
 
-SensorManager sensorManager;
-HistoryManager historyManager;
-ChargerController chargerController;
-UIManager uiManager;
+static void IRAM_ATTR onPowerMonitorReady(void* monitor) {
+    static_cast<AsyncSensor*>(monitor)->onReady();
+}
 
 void setup() {
     Serial.begin(115200);
@@ -215,24 +413,54 @@ void setup() {
     ledcSetup(0, 20000, 8);
     ledcAttachPin(Config::PWM_PIN, 0);
     
+    // Before anything can turn the PWM on
+    safetyInterlock.begin();
+    safetyInterlock.startAcquisition();
+
+    memoryProfiler.addTask("loop", xTaskGetCurrentTaskHandle(), Config::LOOP_STACK_MIN_FREE);
+    memoryProfiler.addTask("interlock", safetyInterlock.acquisitionTask(), Config::INTERLOCK_STACK_MIN_FREE);
+    for (const char* screen : { "main", "graph" }) {
+        memoryProfiler.setBudget(screen, { Config::SCREEN_HEAP_BUDGET_BYTES, Config::MIN_LARGEST_FREE_BLOCK });
+    }
+
     chargerController.begin();
     uiManager.begin();
+
+    // The display has brought up Wire by now
+    if (Config::USE_POWER_MONITOR && powerMonitor.begin()) {
+        pinMode(Config::POWER_MONITOR_ALERT_PIN, INPUT_PULLUP);
+        attachInterruptArg(digitalPinToInterrupt(Config::POWER_MONITOR_ALERT_PIN),
+                           onPowerMonitorReady, &powerMonitor, FALLING);
+        powerMonitor.attach(busScheduler, Config::POWER_MONITOR_DEADLINE_US, true);
+        SensorManager::usePowerMonitor(&powerMonitor);
+    }
+}
+
+// Runs what buttons asked for, outside input handling and drawing
+static void applyAction(const Action& action) {
+    switch (action.type) {
+        case ActionType::START_CHARGING:
+            chargerController.startCharging();
+            break;
+    }
 }
 
 void loop() {
-    static unsigned long lastSensorUpdate = 0;
-    unsigned long currentTime = millis();
+    static PeriodicTimer sensorTimer(Config::SENSOR_UPDATE_INTERVAL_US);
 
     // Update sensors
-    if (currentTime - lastSensorUpdate >= Config::SENSOR_UPDATE_INTERVAL) {
-        lastSensorUpdate = currentTime;
-        
+    if (sensorTimer.due(systemClock)) {
         auto sensorData = SensorManager::readSensors();
         historyManager.addPoint(sensorData);
         
-        chargerController.update();
+        chargerController.update(sensorData);
     }
     
     // Update UI
     uiManager.update();
+
+    actionQueue.drain(applyAction);
+
+    // Sensor transactions and display chunks that are due on the I2C bus
+    while (busScheduler.poll()) {}
 }
@@ -1,12 +1,20 @@
 // sensor_manager.cpp
 #include "sensor_manager.h"
 #include "config.h"
+#include "power_monitors.h"
 #include <Arduino.h>
 
+const PowerMonitor* SensorManager::powerMonitor = nullptr;
+
 SensorManager::SensorData SensorManager::readSensors() {
     SensorData data;
-    data.voltage = readBatteryVoltage();
-    data.current = readChargeCurrent();
+    if (powerMonitor) {
+        data.voltage = powerMonitor->busVolts();
+        data.current = powerMonitor->amps();
+    } else {
+        data.voltage = readBatteryVoltage();
+        data.current = readChargeCurrent();
+    }
     data.temperature = readTemperature(Config::TEMP_PIN);
     data.ambientTemperature = readTemperature(Config::AMBIENT_TEMP_PIN);
     return data;
@@ -20,18 +28,13 @@ float SensorManager::readBatteryVoltage() {
 }
 
 float SensorManager::readChargeCurrent() {
-    constexpr float CURRENT_SENSE_FACTOR = 0.1f;
     float adcValue = analogRead(Config::CURRENT_PIN);
-    return ((adcValue / 4095.0f) * 3.3f) / CURRENT_SENSE_FACTOR;
+    return ((adcValue / ADC_MAX) * ADC_REFERENCE) / CURRENT_SENSE_FACTOR;
 }
 
 float SensorManager::readTemperature(int pin) {
-    constexpr float BETA = 3950.0f;
-    constexpr float R25 = 10000.0f;
-    constexpr float R_SERIES = 10000.0f;
-    
     float adcValue = analogRead(pin);
-    float resistance = R_SERIES * ((4095.0f / adcValue) - 1.0f);
+    float resistance = R_SERIES * ((ADC_MAX / adcValue) - 1.0f);
     float steinhart = log(resistance / R25) / BETA;
     steinhart += 1.0f / (25.0f + 273.15f);
     return (1.0f / steinhart) - 273.15f;
@@ -41,18 +44,13 @@ float SensorManager::readTemperature(int pin) {
 #include "history_manager.h"
 
 void HistoryManager::addPoint(const SensorManager::SensorData& data) {
-    static unsigned long lastUpdate = 0;
-    unsigned long currentTime = millis();
-    
-    if (currentTime - lastUpdate >= Config::HISTORY_UPDATE_INTERVAL) {
-        lastUpdate = currentTime;
-        
+    if (updateTimer.due(clock)) {
         // Update main history
         history[historyIndex] = {
             data.voltage,
             data.current,
             data.temperature - data.ambientTemperature,
-            currentTime
+            updateTimer.lastFiredUs()
         };
         historyIndex = (historyIndex + 1) % HISTORY_SIZE;
         
@@ -83,7 +81,7 @@ std::vector<HistoryPoint> HistoryManager::getVisibleHistory() const {
     
     for (int i = 0; i < HISTORY_SIZE; i++) {
         int idx = (start + i) % HISTORY_SIZE;
-        if (history[idx].timestamp > 0) {
+        if (history[idx].timestampUs > 0) {
             visible.push_back(history[idx]);
         }
     }
@@ -93,6 +91,16 @@ std::vector<HistoryPoint> HistoryManager::getVisibleHistory() const {
 
 // charger_controller.cpp
 #include "charger_controller.h"
+#include "host_shim.h"
+
+static const char* interlockReasonText(SafetyInterlock::Reason reason) {
+    switch (reason) {
+        case SafetyInterlock::Reason::OVER_TEMPERATURE: return "Error - Overtemp";
+        case SafetyInterlock::Reason::OVER_CURRENT: return "Error - Overcurrent";
+        case SafetyInterlock::Reason::SENSOR_FAULT: return "Error - Sensor fault";
+        default: return "Error - Interlock";
+    }
+}
 
 void ChargerController::begin() {
     state = ChargerState::IDLE;
@@ -101,22 +109,36 @@ void ChargerController::begin() {
     ledcWrite(0, 0);
 }
 
-void ChargerController::update() {
+// Takes the sample the main loop just read, so the same decisions can be
+// replayed from a recording (see replay.cpp)
+void ChargerController::update(const SensorManager::SensorData& sensorData) {
     if (!charging) return;
-    
-    auto sensorData = SensorManager::readSensors();
+
+    // The interlock has already cut the PWM if it tripped; a sample count
+    // that stopped moving means it can't be relied on to do so
+    uint32_t samples = interlock.sampleCount();
+    bool interlockAlive = samples != lastInterlockSamples;
+    lastInterlockSamples = samples;
+    if (interlock.isTripped()) {
+        fail(interlockReasonText(interlock.getReason()));
+        return;
+    }
+    if (!interlockAlive) {
+        fail("Error - Interlock stopped");
+        return;
+    }
     
     switch (state) {
         case ChargerState::CHARGING:
-            if (sensorData.temperature > Config::MAX_TEMP || 
-                checkTemperatureTermination(sensorData)) {
-                state = ChargerState::ERROR;
-                stopCharging();
-            } else if (historyManager.detectMinusAV()) {
+            if (sensorData.temperature > Config::MAX_TEMP) {
+                fail("Error - Overtemp");
+            } else if (checkTemperatureTermination(sensorData)) {
+                fail("Error - Temp rise");
+            } else if (history.detectMinusAV()) {
                 state = ChargerState::TRICKLE;
-                setPWMDutyCycle(Config::TRICKLE_CURRENT_MA);
+                setPWMDutyCycle(Config::TRICKLE_CURRENT_MA, sensorData.current * 1000.0f);
             } else {
-                setPWMDutyCycle(Config::CHARGE_CURRENT_MA);
+                setPWMDutyCycle(Config::CHARGE_CURRENT_MA, sensorData.current * 1000.0f);
             }
             break;
             
@@ -140,12 +162,26 @@ void ChargerController::update() {
 }
 
 void ChargerController::startCharging() {
-    if (!charging) {
-        charging = true;
-        state = ChargerState::CHARGING;
-        chargeStartTime = millis();
-        capacityMah = 0.0f;
+    if (charging) return;
+
+    // reset() refuses while any limit is still exceeded
+    if (interlock.isTripped() && !interlock.reset()) {
+        fail(interlockReasonText(interlock.getReason()));
+        return;
     }
+
+    charging = true;
+    state = ChargerState::CHARGING;
+    chargeStartUs = clock.nowUs();
+    lastCapacityUs = chargeStartUs;
+    lastInterlockSamples = interlock.sampleCount() - 1;   // Judge liveness from the next tick
+    capacityMah = 0.0f;
+}
+
+void ChargerController::fail(const char* why) {
+    state = ChargerState::ERROR;
+    errorText = why;
+    stopCharging();
 }
 
 void ChargerController::stopCharging() {
@@ -153,25 +189,19 @@ void ChargerController::stopCharging() {
     ledcWrite(0, 0);
 }
 
-void ChargerController::setPWMDutyCycle(float targetCurrentMA) {
+void ChargerController::setPWMDutyCycle(float targetCurrentMA, float measuredCurrentMA) {
     constexpr float Kp = 0.1f;
-    auto sensorData = SensorManager::readSensors();
-    float error = targetCurrentMA - sensorData.current;
+    float error = targetCurrentMA - measuredCurrentMA;
     int pwm = constrain(ledcRead(0) + Kp * error, 0, 255);
     ledcWrite(0, pwm);
 }
 
 bool ChargerController::checkTemperatureTermination(const SensorManager::SensorData& data) {
-    static float lastTempDelta = 0;
-    static unsigned long lastTempCheck = 0;
-    
-    unsigned long currentTime = millis();
-    if (currentTime - lastTempCheck >= 60000) {
+    if (tempCheckTimer.due(clock)) {
         float currentTempDelta = data.temperature - data.ambientTemperature;
         float tempRise = currentTempDelta - lastTempDelta;
         
         lastTempDelta = currentTempDelta;
-        lastTempCheck = currentTime;
         
         return (currentTempDelta > Config::DT_THRESHOLD || 
                 tempRise > Config::MAX_DT_RATE);
@@ -179,8 +209,12 @@ bool ChargerController::checkTemperatureTermination(const SensorManager::SensorD
     return false;
 }
 
+// Integrates over the time actually elapsed rather than assuming the
+// nominal sensor interval; amps times microseconds over 3.6e6 is mAh
 void ChargerController::updateCapacity(float current) {
-    capacityMah += (current * 0.1f) / 3600.0f;
+    uint64_t now = clock.nowUs();
+    capacityMah += current * (float)(now - lastCapacityUs) / 3.6e6f;
+    lastCapacityUs = now;
 }
 
 const char* ChargerController::getStateString() const {
@@ -189,7 +223,7 @@ const char* ChargerController::getStateString() const {
         case ChargerState::CHARGING: return "Fast Charging";
         case ChargerState::TRICKLE: return "Trickle Charging";
         case ChargerState::COMPLETE: return "Charge Complete";
-        case ChargerState::ERROR: return "Error - Overtemp";
+        case ChargerState::ERROR: return errorText;
         default: return "Unknown State";
     }
 }
@@ -209,7 +243,7 @@ void IRManager::update() {
         
         if (code == 0xFFFFFFFF) {
             if (lastCode != 0 && 
-                millis() - lastCommandTime >= REPEAT_DELAY) {
+                clock.nowUs() - lastCommandUs >= Config::IR_REPEAT_DELAY_US) {
                 code = lastCode;
             } else {
                 receiver.resume();
@@ -223,7 +257,7 @@ void IRManager::update() {
                     cmd.handler();
                 }
                 lastCode = code;
-                lastCommandTime = millis();
+                lastCommandUs = clock.nowUs();
                 break;
             }
         }
@@ -271,20 +305,35 @@ void Widget::markDirty() {
 
 // ui_manager.cpp
 #include "ui_manager.h"
+#include "charger_screens.h"
 
 class UIManager {
 private:
+    Clock& clock;
+    BusScheduler& bus;
+    MemoryProfiler& profiler;
     Adafruit_SSD1306 display;
+    SSD1306Flusher flusher;
     IRManager irManager;
     std::vector<std::unique_ptr<Screen>> screens;
     ScreenType currentScreen;
-    unsigned long lastUpdate;
+    ScreenType requestedScreen;     // Taken up by update() between flushes
+    PeriodicTimer updateTimer;
+
+    // A flush waits at most this long for a gap between sensor reads
+    static constexpr uint64_t FLUSH_MAX_DEFER_US = 20000;
 
 public:
-    UIManager() 
-        : display(Config::SCREEN_WIDTH, Config::SCREEN_HEIGHT, &Wire, Config::OLED_RESET),
+    UIManager(Clock& clock, BusScheduler& bus, MemoryProfiler& profiler)
+        : clock(clock),
+          bus(bus),
+          profiler(profiler),
+          display(Config::SCREEN_WIDTH, Config::SCREEN_HEIGHT, &Wire, Config::OLED_RESET),
+          flusher(display, Config::SCREEN_ADDRESS),
+          irManager(clock),
           currentScreen(ScreenType::MAIN_SCREEN),
-          lastUpdate(0) {}
+          requestedScreen(ScreenType::MAIN_SCREEN),
+          updateTimer(Config::UI_UPDATE_INTERVAL_US) {}
 
     bool begin() {
         if (!display.begin(SSD1306_SWITCHCAPVCC, Config::SCREEN_ADDRESS)) {
@@ -299,35 +348,57 @@ public:
         irManager.begin(Config::IR_RECEIVE_PIN);
         setupScreens();
         setupCommands();
+        profiler.enterScope(screenName(currentScreen));
 
         return true;
     }
 
     void update() {
-        unsigned long currentTime = millis();
-        if (currentTime - lastUpdate < Config::UI_UPDATE_INTERVAL) {
+        if (!updateTimer.due(clock)) {
             return;
         }
-        lastUpdate = currentTime;
 
         irManager.update();
+
+        // The previous frame is still going out between sensor reads
+        if (bus.backgroundPending()) {
+            return;
+        }
+
+        if (requestedScreen != currentScreen) {
+            currentScreen = requestedScreen;
+            profiler.enterScope(screenName(currentScreen));
+        }
         
         if (auto* screen = getCurrentScreen()) {
             screen->update();
             display.clearDisplay();
             screen->draw(display);
-            display.display();
+            profiler.sample();
+
+            // Sent in chunks by the bus scheduler instead of display(),
+            // which would hold the bus for a whole frame
+            flusher.start();
+            bus.startBackground([this]() { return flusher.step(); },
+                                SSD1306Flusher::chunkCostUs(), FLUSH_MAX_DEFER_US);
         }
     }
 
+    // Called from IR commands, possibly mid-flush: the buffer is still
+    // going out, so the switch waits for update()
     void setScreen(ScreenType type) {
         if (type < screens.size() && screens[type]) {
-            currentScreen = type;
-            display.clearDisplay();
+            requestedScreen = type;
         }
     }
 
 private:
+    // Memory profiler scope names, indexed by ScreenType
+    static const char* screenName(ScreenType type) {
+        static const char* const NAMES[] = { "main", "graph" };
+        return NAMES[static_cast<size_t>(type)];
+    }
+
     Screen* getCurrentScreen() {
         return currentScreen < screens.size() ? screens[currentScreen].get() : nullptr;
     }
@@ -346,6 +417,10 @@ private:
         irManager.addCommand(IRCodes::GREEN,
             [this]() { setScreen(ScreenType::GRAPH_SCREEN); },
             "Switch to Graph Screen");
+
+        irManager.addCommand(IRCodes::BLUE,
+            [this]() { profiler.report(); },
+            "Print memory report");
             
         // Add other common commands...
     }
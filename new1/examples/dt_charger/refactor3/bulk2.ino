@@ -4,6 +4,8 @@
 
 // ... (previous declarations) ...
 
+#include "Adafruit_SSD1306.h"   // WHITE and BLACK
+
 class Label : public Widget {
 private:
     String text;
@@ -12,7 +14,7 @@ private:
 public:
     Label(int16_t x, int16_t y, int16_t w, int16_t h, const String& text, bool centered = false);
     void setText(const String& newText);
-    void draw(Adafruit_SSD1306& display) override;
+    void draw(Adafruit_GFX& display) override;
     void handleInput(const IRCommand& cmd) override;
     void update() override;
 };
@@ -26,24 +28,86 @@ public:
     Button(int16_t x, int16_t y, int16_t w, int16_t h, 
            const String& label, std::function<void()> callback);
     void setLabel(const String& newLabel);
-    void draw(Adafruit_SSD1306& display) override;
+    void draw(Adafruit_GFX& display) override;
     void handleInput(const IRCommand& cmd) override;
     void update() override;
 };
 
+// Number with a unit. Precision (decimals), Width (characters of the
+// number, sign and point included), the unit text and the deadband (in
+// counts of the last digit) are template arguments, so the scale factor
+// and every glyph position are compile-time constants and setValue() is a
+// multiply and an integer compare. The UI manager repaints the whole
+// frame, so draw() renders the full fixed-width field, without printf.
+template <uint8_t Precision, uint8_t Width, const char* Unit, uint8_t Deadband = 1>
 class FloatDisplay : public Widget {
+    static_assert(Width > Precision + (Precision ? 1 : 0), "Width must fit the decimals");
+    static_assert(Width <= 12, "Width is limited to 12 characters");
+
 private:
-    float value;
-    int precision;
-    const char* units;
-    
+    static constexpr int32_t pow10(uint8_t n) { return n == 0 ? 1 : 10 * pow10(n - 1); }
+    static constexpr float SCALE = pow10(Precision);
+    static constexpr int16_t CHAR_W = 6;
+    static constexpr int16_t UNIT_OFFSET = (Width + 1) * CHAR_W;
+
+    int32_t scaled;          // Value in counts of the last digit
+
+    // Right-aligned fixed-width rendering of scaled; dashes if it won't fit
+    static void format(int32_t value, char* out) {
+        uint32_t v = value < 0 ? -value : value;
+        int8_t pos = Width;
+        bool fits = false;
+        for (uint8_t d = 0; ; d++) {
+            if (Precision > 0 && d == Precision) {
+                if (--pos < 0) break;
+                out[pos] = '.';
+            }
+            if (--pos < 0) break;
+            out[pos] = '0' + v % 10;
+            v /= 10;
+            if (v == 0 && d >= Precision) {
+                fits = true;
+                break;
+            }
+        }
+        if (fits && value < 0) {
+            fits = --pos >= 0;
+            if (fits) out[pos] = '-';
+        }
+        if (!fits) {
+            memset(out, '-', Width);
+            return;
+        }
+        memset(out, ' ', pos);
+    }
+
 public:
-    FloatDisplay(int16_t x, int16_t y, int16_t w, int16_t h, 
-                int precision, const char* units);
-    void setValue(float newValue);
-    void draw(Adafruit_SSD1306& display) override;
-    void handleInput(const IRCommand& cmd) override;
-    void update() override;
+    FloatDisplay(int16_t x, int16_t y, int16_t w, int16_t h)
+        : Widget(x, y, w, h), scaled(0) {}
+
+    void setValue(float newValue) {
+        int32_t s = lroundf(newValue * SCALE);
+        if (abs(s - scaled) >= Deadband) {
+            scaled = s;
+            dirty = true;
+        }
+    }
+
+    float getValue() const { return scaled / SCALE; }
+
+    void draw(Adafruit_GFX& display) override {
+        char text[Width];
+        format(scaled, text);
+        for (uint8_t i = 0; i < Width; i++) {
+            display.drawChar(x + i * CHAR_W, y, text[i], WHITE, BLACK, 1);
+        }
+        display.setTextColor(WHITE);
+        display.setCursor(x + UNIT_OFFSET, y);
+        display.print(Unit);
+    }
+
+    void handleInput(const IRCommand& cmd) override {}
+    void update() override {}
 };
 
 class BatteryWidget : public Widget {
@@ -55,7 +119,7 @@ private:
 public:
     BatteryWidget(int16_t x, int16_t y, int16_t w, int16_t h);
     void updateValues(float voltage, float current);
-    void draw(Adafruit_SSD1306& display) override;
+    void draw(Adafruit_GFX& display) override;
     void handleInput(const IRCommand& cmd) override;
     void update() override;
 };
@@ -71,7 +135,7 @@ public:
                const HistoryManager& history);
     void setGraphType(GraphType type);
     void adjustTimeScale(float factor);
-    void draw(Adafruit_SSD1306& display) override;
+    void draw(Adafruit_GFX& display) override;
     void handleInput(const IRCommand& cmd) override;
     void update() override;
     
@@ -97,7 +161,7 @@ void Label::setText(const String& newText) {
     }
 }
 
-void Label::draw(Adafruit_SSD1306& display) {
+void Label::draw(Adafruit_GFX& display) {
     display.setTextColor(WHITE);
     if (centered) {
         int16_t textWidth = text.length() * 6; // Assuming 6px font
@@ -129,7 +193,7 @@ void Button::setLabel(const String& newLabel) {
     }
 }
 
-void Button::draw(Adafruit_SSD1306& display) {
+void Button::draw(Adafruit_GFX& display) {
     display.drawRect(x, y, width, height, WHITE);
     
     if (focused) {
@@ -155,34 +219,6 @@ void Button::update() {
     // Buttons don't need regular updates
 }
 
-// FloatDisplay Implementation
-FloatDisplay::FloatDisplay(int16_t x, int16_t y, int16_t w, int16_t h,
-                         int precision, const char* units)
-    : Widget(x, y, w, h), value(0), precision(precision), units(units) {}
-
-void FloatDisplay::setValue(float newValue) {
-    if (value != newValue) {
-        value = newValue;
-        dirty = true;
-    }
-}
-
-void FloatDisplay::draw(Adafruit_SSD1306& display) {
-    display.setTextColor(WHITE);
-    display.setCursor(x, y);
-    display.print(value, precision);
-    display.print(" ");
-    display.print(units);
-}
-
-void FloatDisplay::handleInput(const IRCommand& cmd) {
-    // FloatDisplays don't handle input
-}
-
-void FloatDisplay::update() {
-    // FloatDisplays are updated through setValue
-}
-
 // BatteryWidget Implementation
 BatteryWidget::BatteryWidget(int16_t x, int16_t y, int16_t w, int16_t h)
     : Widget(x, y, w, h), voltage(0), current(0), percentage(0) {}
@@ -196,7 +232,7 @@ void BatteryWidget::updateValues(float newVoltage, float newCurrent) {
     dirty = true;
 }
 
-void BatteryWidget::draw(Adafruit_SSD1306& display) {
+void BatteryWidget::draw(Adafruit_GFX& display) {
     // Draw battery outline
     display.drawRect(x, y + 2, width - 10, height - 4, WHITE);
     display.fillRect(x + width - 10, y + height/3, 10, height/3, WHITE);
@@ -273,7 +309,7 @@ std::pair<float, float> GraphWidget::calculateRange() const {
     return {minVal - padding, maxVal + padding};
 }
 
-void GraphWidget::draw(Adafruit_SSD1306& display) {
+void GraphWidget::draw(Adafruit_GFX& display) {
     // Draw axes
     display.drawLine(x, y + height - 1, x + width - 1, y + height - 1, WHITE);
     display.drawLine(x, y, x, y + height - 1, WHITE);
@@ -351,19 +387,34 @@ public:
 
     virtual void handleInput(const IRCommand& cmd);
     virtual void update();
-    virtual void draw(Adafruit_SSD1306& display);
+    virtual void draw(Adafruit_GFX& display);
 
 protected:
     void changeFocus(int direction);
 };
 
+#endif // SCREEN_H
+
+// charger_screens.h
+#ifndef CHARGER_SCREENS_H
+#define CHARGER_SCREENS_H
+
+#include "screen.h"
+#include "history_manager.h"
+
+// Main screen readouts; 0.2 C deadband keeps ADC noise off the display
+extern const char UNIT_TEMP[];
+extern const char UNIT_MAH[];
+typedef FloatDisplay<1, 5, UNIT_TEMP, 2> TempDisplay;
+typedef FloatDisplay<0, 5, UNIT_MAH> CapacityDisplay;
+
 // MainScreen and GraphScreen implementations...
 class MainScreen : public Screen {
 private:
     Label* titleLabel;
     BatteryWidget* batteryWidget;
-    FloatDisplay* tempDisplay;
-    FloatDisplay* capacityDisplay;
+    TempDisplay* tempDisplay;
+    CapacityDisplay* capacityDisplay;
     Button* chargeButton;
     
 public:
@@ -382,7 +433,7 @@ public:
     void update() override;
 };
 
-#endif // SCREEN_H
+#endif // CHARGER_SCREENS_H
 
 // screen.cpp
 #include "screen.h"
@@ -401,7 +452,7 @@ void Screen::update() {
     }
 }
 
-void Screen::draw(Adafruit_SSD1306& display) {
+void Screen::draw(Adafruit_GFX& display) {
     for (auto& widget : widgets) {
         if (widget->isDirty()) {
             widget->draw(display);
@@ -424,14 +475,21 @@ void Screen::changeFocus(int direction) {
     widgets[focusedWidget]->setFocus(true);
 }
 
+// charger_screens.cpp
+#include "charger_screens.h"
+#include "globals.h"
+
+const char UNIT_TEMP[] = "°C";
+const char UNIT_MAH[] = "mAh";
+
 // MainScreen Implementation
 MainScreen::MainScreen() {
     titleLabel = addWidget<Label>(0, 0, 128, 10, "NiMH Charger", true);
     batteryWidget = addWidget<BatteryWidget>(0, 12, 128, 20);
-    tempDisplay = addWidget<FloatDisplay>(0, 34, 128, 10, 1, "°C");
-    capacityDisplay = addWidget<FloatDisplay>(0, 44, 128, 10, 0, "mAh");
+    tempDisplay = addWidget<TempDisplay>(0, 34, 128, 10);
+    capacityDisplay = addWidget<CapacityDisplay>(0, 44, 128, 10);
     chargeButton = addWidget<Button>(14, 54, 100, 10, "Start Charging",
-        []() { chargerController.startCharging(); });
+        []() { actionQueue.post(ActionType::START_CHARGING); });
 }
 
 // Complete MainScreen implementation
@@ -482,7 +540,6 @@ void GraphScreen::update() {
     // No additional updates needed
 }
 
-
 /*
 // UIManager implementation completions
 enum class ScreenType {
@@ -6,6 +6,10 @@
 #include <memory>
 #include <vector>
 #include "config.h"
+#include "clock.h"
+#include "bus_scheduler.h"
+#include "ssd1306_flusher.h"
+#include "memory_profiler.h"
 #include "ir_manager.h"
 #include "screen.h"
 
@@ -27,18 +31,24 @@ enum class GraphType {
 
 class UIManager {
 public:
-    UIManager();
+    UIManager(Clock& clock, BusScheduler& bus, MemoryProfiler& profiler);
     bool begin();
     void update();
     void setScreen(ScreenType type);
 
 private:
+    Clock& clock;
+    BusScheduler& bus;
+    MemoryProfiler& profiler;
     Adafruit_SSD1306 display;
+    SSD1306Flusher flusher;
     IRManager irManager;
     std::vector<std::unique_ptr<Screen>> screens;
     ScreenType currentScreen;
-    unsigned long lastUpdate;
+    ScreenType requestedScreen;
+    PeriodicTimer updateTimer;
 
+    static const char* screenName(ScreenType type);
     Screen* getCurrentScreen();
     void setupScreens();
     void setupCommands();
@@ -46,40 +56,141 @@ private:
 
 #endif // UI_MANAGER_H
 
+// action_queue.h
+#ifndef ACTION_QUEUE_H
+#define ACTION_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Things buttons ask the control loop to do
+enum class ActionType : uint8_t {
+    START_CHARGING
+};
+
+struct Action {
+    ActionType type;
+    uint32_t arg;
+};
+
+// Bounded lock-free queue of actions. Button handlers only post (a copy
+// and an index bump); loop() drains the queue at one defined point,
+// outside of input handling and drawing, so a press never runs charger
+// work from inside Screen::handleInput. Safe for one producer and one
+// consumer.
+template <size_t CAPACITY>
+class ActionQueue {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+private:
+    Action slots[CAPACITY];
+    std::atomic<uint32_t> head{0};     // Next slot to read, owned by the consumer
+    std::atomic<uint32_t> tail{0};     // Next slot to write, owned by the producer
+    std::atomic<uint32_t> droppedCount{0};
+
+public:
+    // Returns false (and counts a drop) if the queue is full
+    bool post(ActionType type, uint32_t arg = 0) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) >= CAPACITY) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[t & (CAPACITY - 1)] = { type, arg };
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(Action& out) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        out = slots[h & (CAPACITY - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Applies at most maxActions queued actions; ones posted meanwhile wait
+    // for the next drain
+    template <typename Handler>
+    size_t drain(Handler handler, size_t maxActions = CAPACITY) {
+        size_t n = 0;
+        Action action;
+        while (n < maxActions && pop(action)) {
+            handler(action);
+            n++;
+        }
+        return n;
+    }
+
+    uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+};
+
+#endif // ACTION_QUEUE_H
+
 // globals.h
 #ifndef GLOBALS_H
-#define UI_MANAGER_H
+#define GLOBALS_H
 
+#include "clock.h"
 #include "sensor_manager.h"
 #include "history_manager.h"
 #include "charger_controller.h"
+#include "safety_interlock.h"
+#include "bus_scheduler.h"
+#include "power_monitors.h"
+#include "memory_profiler.h"
+#include "action_queue.h"
 #include "ui_manager.h"
 
 // Global objects declaration
+// On the ESP32 time comes from esp_timer; host builds drive a virtual clock
+#ifdef ARDUINO
+extern HardwareClock systemClock;
+#else
+extern VirtualClock systemClock;
+#endif
 extern SensorManager sensorManager;
+extern SafetyInterlock safetyInterlock;
+extern BusScheduler busScheduler;
+#ifdef ARDUINO
+extern WireRegisterBus i2cRegisters;
+extern Ina226 powerMonitor;
+extern EspMemorySource memorySource;
+#else
+extern MallocMemorySource memorySource;
+#endif
+extern MemoryProfiler memoryProfiler;
 extern HistoryManager historyManager;
 extern ChargerController chargerController;
 extern UIManager uiManager;
-
-// IR Codes namespace
-namespace IRCodes {
-    constexpr uint32_t UP = 0x18;
-    constexpr uint32_t DOWN = 0x52;
-    constexpr uint32_t LEFT = 0x08;
-    constexpr uint32_t RIGHT = 0x5A;
-    constexpr uint32_t OK = 0x1C;
-    constexpr uint32_t RED = 0x45;
-    constexpr uint32_t GREEN = 0x46;
-    constexpr uint32_t BLUE = 0x47;
-}
+extern ActionQueue<Config::ACTION_QUEUE_SIZE> actionQueue;
 
 #endif // GLOBALS_H
 
 // globals.cpp
+#include <stdio.h>
 #include "globals.h"
 
 // Global objects definition
+#ifdef ARDUINO
+HardwareClock systemClock;
+#else
+VirtualClock systemClock;
+#endif
 SensorManager sensorManager;
-HistoryManager historyManager;
-ChargerController chargerController;
-UIManager uiManager;
+SafetyInterlock safetyInterlock;
+BusScheduler busScheduler(systemClock);
+#ifdef ARDUINO
+WireRegisterBus i2cRegisters(Wire);
+Ina226 powerMonitor(i2cRegisters, Config::POWER_MONITOR_ADDRESS, Config::SHUNT_OHMS);
+EspMemorySource memorySource;
+MemoryProfiler memoryProfiler(memorySource, [](const char* line) { Serial.println(line); });
+#else
+MallocMemorySource memorySource;
+MemoryProfiler memoryProfiler(memorySource, [](const char* line) { puts(line); });
+#endif
+HistoryManager historyManager(systemClock);
+ChargerController chargerController(systemClock, historyManager, safetyInterlock);
+UIManager uiManager(systemClock, busScheduler, memoryProfiler);
+ActionQueue<Config::ACTION_QUEUE_SIZE> actionQueue;
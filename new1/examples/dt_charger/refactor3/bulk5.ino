@@ -0,0 +1,266 @@
+// host_shim.h
+// The Arduino calls the portable sources make. On the device they come
+// from Arduino.h; host tools get declarations here and define ledcWrite()
+// and ledcRead() themselves, to suit what each one checks.
+#ifndef HOST_SHIM_H
+#define HOST_SHIM_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcRead(uint8_t channel);
+
+// Arduino's constrain() is a macro; this takes the same mixed arguments
+template <typename T, typename L, typename H>
+auto constrain(T x, L low, H high) -> decltype(x + low + high) {
+    return x < low ? low : (x > high ? high : x);
+}
+#endif
+
+#endif // HOST_SHIM_H
+
+// replay.cpp
+// Host-only: replays recorded charge sessions through the charger logic
+// as fast as it will run, timing every tick and checking the decisions
+// against what the charger did in the field.
+//
+//   replay session1.csv [session2.csv ...]
+//
+// Log format, one sample per line, '#' starts a comment:
+//   t_us,voltage,current,temperature,ambient,state
+// where state is the recorded ChargerState name (IDLE, CHARGING, ...).
+// A "# expect capacity_mah <n>" line makes the replay check the charge
+// counted by the end as well. sessions/short_charge.csv is a small
+// session that replays clean.
+//
+// The host tools build from the files the bulk*.ino sketches hold, split
+// out at their "// name.h" and "// name.cpp" markers. From this directory:
+//   mkdir -p /tmp/dt_host
+//   awk -v out=/tmp/dt_host 'FNR == 1 { f = "" } /^\/\/ [A-Za-z0-9_]+\.(h|cpp)$/ { f = out "/" $2 } f { print > f }' bulk*.ino
+//   (cd /tmp/dt_host && g++ -std=c++17 -O2 -Wall -I. replay.cpp charger_controller.cpp history_manager.cpp safety_interlock.cpp -o replay)
+//   /tmp/dt_host/replay sessions/short_charge.csv
+#ifndef ARDUINO
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "config.h"
+#include "clock.h"
+#include "sensor_manager.h"
+#include "history_manager.h"
+#include "charger_controller.h"
+#include "safety_interlock.h"
+#include "host_shim.h"
+
+// Stand-in for the LEDC driver; the controller only needs its duty back
+static uint32_t pwmDuty = 0;
+void ledcWrite(uint8_t, uint32_t duty) { pwmDuty = duty; }
+uint32_t ledcRead(uint8_t) { return pwmDuty; }
+
+namespace {
+
+const char* const STATE_NAMES[] = { "IDLE", "CHARGING", "TRICKLE", "COMPLETE", "ERROR" };
+constexpr int STATE_COUNT = sizeof(STATE_NAMES) / sizeof(STATE_NAMES[0]);
+constexpr float CAPACITY_TOLERANCE_MAH = 0.1f;
+
+struct Sample {
+    uint64_t timeUs;
+    SensorManager::SensorData data;
+    ChargerState state;
+};
+
+struct Transition {
+    uint64_t timeUs;
+    ChargerState from, to;
+};
+
+const char* stateName(ChargerState state) {
+    int i = (int)state;
+    return i >= 0 && i < STATE_COUNT ? STATE_NAMES[i] : "?";
+}
+
+bool parseState(const char* text, ChargerState& state) {
+    for (int i = 0; i < STATE_COUNT; i++) {
+        if (strcmp(text, STATE_NAMES[i]) == 0) {
+            state = (ChargerState)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// expectedMah is left NaN if the session doesn't give one
+bool loadSession(const char* path, std::vector<Sample>& samples, float& expectedMah) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "%s: can't open\n", path);
+        return false;
+    }
+
+    char line[160];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), file)) {
+        lineNo++;
+        if (sscanf(line, "# expect capacity_mah %f", &expectedMah) == 1) continue;
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        Sample s;
+        unsigned long long t;
+        char state[16];
+        if (sscanf(line, "%llu,%f,%f,%f,%f,%15s", &t, &s.data.voltage, &s.data.current,
+                   &s.data.temperature, &s.data.ambientTemperature, state) != 6 ||
+            !parseState(state, s.state)) {
+            fprintf(stderr, "%s:%d: bad sample\n", path, lineNo);
+            fclose(file);
+            return false;
+        }
+        s.timeUs = t;
+        if (!samples.empty() && s.timeUs < samples.back().timeUs) {
+            fprintf(stderr, "%s:%d: time goes backwards\n", path, lineNo);
+            fclose(file);
+            return false;
+        }
+        samples.push_back(s);
+    }
+    fclose(file);
+    return true;
+}
+
+std::vector<Transition> transitionsOf(const std::vector<Sample>& samples) {
+    std::vector<Transition> out;
+    for (size_t i = 1; i < samples.size(); i++) {
+        if (samples[i].state != samples[i - 1].state) {
+            out.push_back({ samples[i].timeUs, samples[i - 1].state, samples[i].state });
+        }
+    }
+    return out;
+}
+
+double seconds(uint64_t us) { return us / 1e6; }
+
+// Replays one session with fresh controller state; returns false if the
+// replayed transitions or capacity don't match the recording
+bool replaySession(const char* path) {
+    std::vector<Sample> samples;
+    float expectedMah = NAN;
+    if (!loadSession(path, samples, expectedMah)) return false;
+    if (samples.empty()) {
+        printf("%s: empty\n", path);
+        return true;
+    }
+
+    VirtualClock clock;
+    HistoryManager history(clock);
+    SafetyInterlock interlock;
+    ChargerController charger(clock, history, interlock);
+
+    clock.advanceTo(samples.front().timeUs);
+    interlock.begin();
+    charger.begin();
+
+    std::vector<uint32_t> tickNs;
+    tickNs.reserve(samples.size());
+    std::vector<Transition> replayed;
+    ChargerState previous = charger.getState();
+
+    for (const Sample& s : samples) {
+        clock.advanceTo(s.timeUs);
+
+        auto start = std::chrono::steady_clock::now();
+        // The recording shows when the user started the charge
+        if (s.state != ChargerState::IDLE && !charger.isCharging() && previous == ChargerState::IDLE) {
+            charger.startCharging();
+        }
+        // The recording is far sparser than the interlock's own sampling,
+        // but each sample still goes through it
+        interlock.onSample(SensorManager::temperatureToRaw(s.data.temperature),
+                           SensorManager::currentToRaw(s.data.current));
+        history.addPoint(s.data);
+        charger.update(s.data);
+        auto end = std::chrono::steady_clock::now();
+
+        tickNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+        if (charger.getState() != previous) {
+            replayed.push_back({ s.timeUs, previous, charger.getState() });
+            previous = charger.getState();
+        }
+    }
+
+    uint64_t totalNs = 0;
+    for (uint32_t ns : tickNs) totalNs += ns;
+    std::vector<uint32_t> sorted = tickNs;
+    std::sort(sorted.begin(), sorted.end());
+
+    printf("%s: %zu ticks over %.1f s recorded\n", path, samples.size(),
+           seconds(samples.back().timeUs - samples.front().timeUs));
+    printf("  tick cost ns: mean %llu  p50 %u  p99 %u  max %u\n",
+           (unsigned long long)(totalNs / tickNs.size()), sorted[sorted.size() / 2],
+           sorted[sorted.size() * 99 / 100], sorted.back());
+    bool capacityMatches = std::isnan(expectedMah) ||
+                           std::fabs(charger.getCapacity() - expectedMah) <= CAPACITY_TOLERANCE_MAH;
+    printf("  final capacity %.1f mAh", charger.getCapacity());
+    if (!std::isnan(expectedMah)) {
+        printf(", expected %.1f%s", expectedMah, capacityMatches ? "" : "  CAPACITY DIFFERS");
+    }
+    printf("\n");
+    if (interlock.isTripped()) {
+        printf("  interlock tripped (reason %d)\n", (int)interlock.getReason());
+    }
+
+    // Pair transitions in order; a change in detection shows up as a
+    // shifted time, a different target state, or an extra/missing entry
+    std::vector<Transition> recorded = transitionsOf(samples);
+    bool match = true;
+    printf("  %-9s %-22s %-22s %s\n", "t (s)", "recorded", "replayed", "delta (s)");
+    for (size_t i = 0; i < std::max(recorded.size(), replayed.size()); i++) {
+        char rec[24] = "-", rep[24] = "-", delta[16] = "";
+        uint64_t t = 0;
+        if (i < recorded.size()) {
+            snprintf(rec, sizeof(rec), "%s->%s", stateName(recorded[i].from), stateName(recorded[i].to));
+            t = recorded[i].timeUs;
+        }
+        if (i < replayed.size()) {
+            snprintf(rep, sizeof(rep), "%s->%s", stateName(replayed[i].from), stateName(replayed[i].to));
+            if (i >= recorded.size()) t = replayed[i].timeUs;
+        }
+        bool same = i < recorded.size() && i < replayed.size() &&
+                    recorded[i].from == replayed[i].from && recorded[i].to == replayed[i].to;
+        if (same) {
+            snprintf(delta, sizeof(delta), "%+.3f",
+                     ((double)replayed[i].timeUs - (double)recorded[i].timeUs) / 1e6);
+            same = replayed[i].timeUs == recorded[i].timeUs;
+        }
+        match &= same;
+        printf("%c %-9.1f %-22s %-22s %s\n", same ? ' ' : '!', seconds(t), rec, rep, delta);
+    }
+    printf("  %s\n", match ? "transitions match" : "TRANSITIONS DIFFER");
+    return match && capacityMatches;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s session.csv [...]\n", argv[0]);
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int differing = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!replaySession(argv[i])) differing++;
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%d session(s), %d differing, %.2f s wall\n", argc - 1, differing, wall);
+    return differing ? 1 : 0;
+}
+
+#endif // ARDUINO
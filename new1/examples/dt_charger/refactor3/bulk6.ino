@@ -0,0 +1,276 @@
+// safety_interlock.h
+#ifndef SAFETY_INTERLOCK_H
+#define SAFETY_INTERLOCK_H
+
+#include <atomic>
+#include <stdint.h>
+#include "config.h"
+
+// Cuts the charge PWM on overtemperature, overcurrent or a failed
+// thermistor without waiting for the main loop. Every raw sample from the
+// acquisition path goes through onSample(), which compares ADC counts
+// against limits converted once in begin(); no floating point, no UI or
+// scheduler state in the way. A trip latches until reset(), which the
+// next press of Start Charging tries (ChargerController::startCharging()).
+//
+// Worst case from a limit being crossed to the PWM going off is
+// INTERLOCK_TRIP_SAMPLES sample periods plus one onSample() call.
+class SafetyInterlock {
+public:
+    enum class Reason : uint8_t {
+        NONE,
+        OVER_TEMPERATURE,
+        OVER_CURRENT,
+        SENSOR_FAULT
+    };
+
+    void begin();
+
+    // Starts the sampling timer and the task that feeds onSample() (ESP32)
+    void startAcquisition();
+
+    // FreeRTOS handle of that task; nullptr before startAcquisition() or on a host
+    void* acquisitionTask() const;
+
+    // Checks one temperature/current sample pair; true if it tripped
+    bool onSample(uint16_t rawTemp, uint16_t rawCurrent);
+
+    // Clears a trip once the last sample is back inside every limit
+    bool reset();
+
+    bool isTripped() const { return reason.load(std::memory_order_acquire) != Reason::NONE; }
+    Reason getReason() const { return reason.load(std::memory_order_acquire); }
+
+    // Increments with every sample, so callers can tell the interlock is running
+    uint32_t sampleCount() const { return samples.load(std::memory_order_relaxed); }
+
+    uint16_t tempLimitRaw() const { return tempLimit; }
+    uint16_t currentLimitRaw() const { return currentLimit; }
+
+private:
+    uint16_t tempLimit = 0;
+    uint16_t tempFloor = 0;
+    uint16_t currentLimit = 0;
+    uint8_t tempOver = 0;
+    uint8_t currentOver = 0;
+    uint8_t sensorOpen = 0;
+    std::atomic<Reason> reason{ Reason::NONE };
+    std::atomic<uint32_t> samples{ 0 };
+
+    void trip(Reason why);
+};
+
+#endif // SAFETY_INTERLOCK_H
+
+// safety_interlock.cpp
+#include "safety_interlock.h"
+#include "sensor_manager.h"
+#include "host_shim.h"
+
+void SafetyInterlock::begin() {
+    // The thermistor reads higher counts as it gets hotter
+    tempLimit = SensorManager::temperatureToRaw(Config::MAX_TEMP);
+    tempFloor = SensorManager::temperatureToRaw(Config::MIN_SENSOR_TEMP);
+    currentLimit = SensorManager::currentToRaw(Config::MAX_CHARGE_CURRENT);
+    tempOver = currentOver = sensorOpen = 0;
+}
+
+static inline void countOver(uint8_t& counter, bool over) {
+    if (!over) counter = 0;
+    else if (counter < Config::INTERLOCK_TRIP_SAMPLES) counter++;
+}
+
+bool SafetyInterlock::onSample(uint16_t rawTemp, uint16_t rawCurrent) {
+    samples.fetch_add(1, std::memory_order_relaxed);
+
+    countOver(tempOver, rawTemp >= tempLimit);
+    countOver(currentOver, rawCurrent >= currentLimit);
+    countOver(sensorOpen, rawTemp <= tempFloor);
+
+    Reason why = Reason::NONE;
+    if (tempOver >= Config::INTERLOCK_TRIP_SAMPLES) why = Reason::OVER_TEMPERATURE;
+    else if (currentOver >= Config::INTERLOCK_TRIP_SAMPLES) why = Reason::OVER_CURRENT;
+    else if (sensorOpen >= Config::INTERLOCK_TRIP_SAMPLES) why = Reason::SENSOR_FAULT;
+
+    if (isTripped()) {
+        // Keep the output forced off in case anything wrote it since
+        ledcWrite(0, 0);
+        return false;
+    }
+    if (why == Reason::NONE) return false;
+
+    trip(why);
+    return true;
+}
+
+void SafetyInterlock::trip(Reason why) {
+    ledcWrite(0, 0);
+    reason.store(why, std::memory_order_release);
+}
+
+bool SafetyInterlock::reset() {
+    if (tempOver || currentOver || sensorOpen) return false;
+    reason.store(Reason::NONE, std::memory_order_release);
+    return true;
+}
+
+#ifdef ARDUINO
+// The sample timer ISR only wakes a task: analogRead() and ledcWrite()
+// take driver locks and live in flash, so they can't run in the ISR
+// itself. The task has the highest priority and core 0 to itself (the
+// sketch loop runs on core 1), so it runs as soon as the ISR returns no
+// matter what the UI is doing.
+static TaskHandle_t interlockTask = nullptr;
+static hw_timer_t* sampleTimer = nullptr;
+
+static void IRAM_ATTR onSampleTimer() {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(interlockTask, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+static void interlockLoop(void* arg) {
+    auto* interlock = static_cast<SafetyInterlock*>(arg);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint16_t rawTemp = analogRead(Config::TEMP_PIN);
+        uint16_t rawCurrent = analogRead(Config::CURRENT_PIN);
+        interlock->onSample(rawTemp, rawCurrent);
+    }
+}
+
+void SafetyInterlock::startAcquisition() {
+    xTaskCreatePinnedToCore(interlockLoop, "interlock", 2048, this,
+                            configMAX_PRIORITIES - 1, &interlockTask, 0);
+
+    // Timer 1 belongs to IRremote: enableIRIn() runs later and would
+    // take over its interrupt, stopping the samples
+    sampleTimer = timerBegin(0, 80, true);   // 1 MHz ticks
+    timerAttachInterrupt(sampleTimer, &onSampleTimer, true);
+    timerAlarmWrite(sampleTimer, 1000000 / Config::INTERLOCK_SAMPLE_HZ, true);
+    timerAlarmEnable(sampleTimer);
+}
+
+void* SafetyInterlock::acquisitionTask() const { return interlockTask; }
+#else
+// Host builds feed onSample() directly
+void SafetyInterlock::startAcquisition() {}
+void* SafetyInterlock::acquisitionTask() const { return nullptr; }
+#endif
+
+// interlock_latency.cpp
+// Host-only: worst-case time from a limit being crossed to the PWM being
+// cut. Steps land at random points between samples, so the measured
+// worst case includes the wait for the next sample; the time spent in
+// onSample() is measured on the host and scaled to the ESP32.
+//
+//   interlock_latency [trials]
+#ifndef ARDUINO
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "sensor_manager.h"
+#include "safety_interlock.h"
+
+static bool pwmCut = false;
+void ledcWrite(uint8_t channel, uint32_t duty) { if (duty == 0) pwmCut = true; }
+
+namespace {
+
+// Assumed costs on the target that a host run can't see
+constexpr double ESP32_SLOWDOWN = 20.0;   // onSample() on a 240 MHz Xtensa vs. the host
+constexpr double TASK_WAKE_US = 10.0;     // ISR return to the interlock task running
+constexpr double ADC_READS_US = 2 * 10.0; // Two analogRead() calls
+
+struct Limit {
+    const char* name;
+    uint16_t tripTemp, tripCurrent;
+};
+
+// Per-call cost of onSample(), as the worst mean over batches of calls.
+// Single-call timings on a desktop OS are dominated by preemption the
+// interlock task never sees on the target.
+double callCostNs(SafetyInterlock& interlock, uint16_t rawTemp, uint16_t rawCurrent) {
+    constexpr int BATCHES = 200, BATCH = 1000;
+    double worst = 0;
+    for (int b = 0; b < BATCHES; b++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BATCH; i++) interlock.onSample(rawTemp, rawCurrent);
+        auto end = std::chrono::steady_clock::now();
+        worst = std::max(worst, std::chrono::duration<double, std::nano>(end - start).count() / BATCH);
+    }
+    return worst;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int trials = argc > 1 ? atoi(argv[1]) : 100000;
+    const double periodUs = 1e6 / Config::INTERLOCK_SAMPLE_HZ;
+
+    SafetyInterlock interlock;
+    interlock.begin();
+    const uint16_t normalTemp = SensorManager::temperatureToRaw(25.0f);
+    const uint16_t normalCurrent = SensorManager::currentToRaw(1.0f);
+
+    const Limit limits[] = {
+        { "overtemperature", interlock.tempLimitRaw(), normalCurrent },
+        { "overcurrent", normalTemp, interlock.currentLimitRaw() },
+        { "open thermistor", 0, normalCurrent },
+    };
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> phase(0.0, periodUs);
+    std::uniform_int_distribution<int> noise(-8, 8);
+    std::uniform_int_distribution<int> lead(0, 50);
+
+    bool ok = true;
+    printf("sample period %.0f us, trip after %u samples, budget %u us\n",
+           periodUs, Config::INTERLOCK_TRIP_SAMPLES, Config::INTERLOCK_MAX_LATENCY_US);
+
+    for (const Limit& limit : limits) {
+        interlock.begin();
+        double callNs = std::max(callCostNs(interlock, normalTemp, normalCurrent),
+                                 callCostNs(interlock, limit.tripTemp, limit.tripCurrent));
+        double handlerUs = TASK_WAKE_US + ADC_READS_US + callNs * ESP32_SLOWDOWN / 1000.0;
+
+        double worstUs = 0;
+        int falseTrips = 0, lateTrips = 0;
+
+        for (int t = 0; t < trials; t++) {
+            interlock.begin();
+            interlock.reset();
+            pwmCut = false;
+
+            // Normal noisy samples first; none of these may trip
+            for (int i = lead(rng); i > 0; i--) {
+                if (interlock.onSample(normalTemp + noise(rng), normalCurrent + noise(rng))) falseTrips++;
+            }
+            interlock.reset();
+
+            // The step happens somewhere inside a sample period
+            double waitUs = periodUs - phase(rng);
+            int samplesTaken = 0;
+            while (!pwmCut && samplesTaken < 100) {
+                interlock.onSample(limit.tripTemp, limit.tripCurrent);
+                samplesTaken++;
+            }
+            if (samplesTaken != Config::INTERLOCK_TRIP_SAMPLES) lateTrips++;
+
+            double latencyUs = waitUs + (samplesTaken - 1) * periodUs + handlerUs;
+            worstUs = std::max(worstUs, latencyUs);
+        }
+
+        bool pass = worstUs <= Config::INTERLOCK_MAX_LATENCY_US && falseTrips == 0 && lateTrips == 0;
+        ok &= pass;
+        printf("%-16s worst %7.1f us  (onSample %.1f ns host)  false trips %d  late trips %d  %s\n",
+               limit.name, worstUs, callNs, falseTrips, lateTrips, pass ? "ok" : "FAIL");
+    }
+
+    return ok ? 0 : 1;
+}
+
+#endif // ARDUINO
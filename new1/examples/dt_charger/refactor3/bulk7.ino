@@ -0,0 +1,349 @@
+// bus_scheduler.h
+#ifndef BUS_SCHEDULER_H
+#define BUS_SCHEDULER_H
+
+#include <functional>
+#include <vector>
+#include "clock.h"
+
+// Shares one I2C bus between periodic device transactions (sensor reads)
+// and long background transfers (display flushes) cut into chunks.
+//
+// Device transactions are released every period (or earlier, when their
+// ready check says so) and run earliest deadline first. A background
+// chunk only goes out if it will be done before the next device release,
+// so a full-screen flush never delays a sensor read; if devices leave no
+// gap for maxDeferUs the chunk goes out anyway so the display can't starve.
+class BusScheduler {
+public:
+    typedef std::function<void()> Transfer;
+    typedef std::function<bool()> ChunkStep;   // Sends one chunk; true once all are sent
+
+    struct Stats {
+        uint32_t runs;
+        uint32_t misses;          // Started later than the device's deadline
+        uint64_t worstLatencyUs;  // Release to start
+        uint64_t totalLatencyUs;
+    };
+
+    explicit BusScheduler(Clock& clock) : clock(clock) {}
+
+    typedef std::function<bool()> ReadyCheck;
+
+    // Registers a transaction that is due every periodUs and should start
+    // within deadlineUs of being due
+    int addDevice(const char* name, uint64_t periodUs, uint64_t deadlineUs, Transfer transfer);
+
+    // Same, but also due as soon as ready() returns true (a data-ready
+    // pin, say); periodUs is then only a timeout in case the event is lost
+    int addDevice(const char* name, uint64_t periodUs, uint64_t deadlineUs, Transfer transfer,
+                  ReadyCheck ready);
+
+    void startBackground(ChunkStep step, uint32_t chunkCostUs, uint64_t maxDeferUs);
+    bool backgroundPending() const { return static_cast<bool>(background); }
+
+    // Runs at most one transaction; false if nothing could go out now
+    bool poll();
+
+    const char* name(int device) const { return devices[device].name; }
+    const Stats& stats(int device) const { return devices[device].stats; }
+    size_t deviceCount() const { return devices.size(); }
+
+private:
+    struct Device {
+        const char* name;
+        uint64_t periodUs;
+        uint64_t deadlineUs;
+        Transfer transfer;
+        ReadyCheck ready;
+        uint64_t releaseUs;
+        Stats stats;
+    };
+
+    Clock& clock;
+    std::vector<Device> devices;
+    ChunkStep background;
+    uint32_t chunkCostUs = 0;
+    uint64_t maxDeferUs = 0;
+    uint64_t lastChunkUs = 0;
+
+    void runDevice(Device& device, uint64_t now);
+};
+
+#endif // BUS_SCHEDULER_H
+
+// bus_scheduler.cpp
+#include <algorithm>
+#include "bus_scheduler.h"
+
+int BusScheduler::addDevice(const char* name, uint64_t periodUs, uint64_t deadlineUs, Transfer transfer) {
+    return addDevice(name, periodUs, deadlineUs, transfer, nullptr);
+}
+
+int BusScheduler::addDevice(const char* name, uint64_t periodUs, uint64_t deadlineUs, Transfer transfer,
+                            ReadyCheck ready) {
+    devices.push_back({ name, periodUs, deadlineUs, transfer, ready, clock.nowUs(), {} });
+    return devices.size() - 1;
+}
+
+void BusScheduler::startBackground(ChunkStep step, uint32_t costUs, uint64_t deferUs) {
+    background = step;
+    chunkCostUs = costUs;
+    maxDeferUs = deferUs;
+    lastChunkUs = clock.nowUs();
+}
+
+bool BusScheduler::poll() {
+    uint64_t now = clock.nowUs();
+    Device* due = nullptr;
+    uint64_t nextRelease = UINT64_MAX;
+
+    for (Device& d : devices) {
+        if (d.releaseUs > now && d.ready && d.ready()) {
+            d.releaseUs = now;
+        }
+        if (d.releaseUs > now) {
+            nextRelease = std::min(nextRelease, d.releaseUs);
+        } else if (!due || d.releaseUs + d.deadlineUs < due->releaseUs + due->deadlineUs) {
+            due = &d;
+        }
+    }
+
+    if (due) {
+        runDevice(*due, now);
+        return true;
+    }
+
+    if (background) {
+        bool fits = now + chunkCostUs <= nextRelease;
+        bool starving = now - lastChunkUs >= maxDeferUs;
+        if (fits || starving) {
+            if (background()) background = nullptr;
+            lastChunkUs = clock.nowUs();
+            return true;
+        }
+        clock.wakeAt(lastChunkUs + maxDeferUs);
+    }
+
+    if (nextRelease != UINT64_MAX) clock.wakeAt(nextRelease);
+    return false;
+}
+
+void BusScheduler::runDevice(Device& device, uint64_t now) {
+    uint64_t latency = now - device.releaseUs;
+    device.transfer();
+
+    Stats& s = device.stats;
+    s.runs++;
+    s.totalLatencyUs += latency;
+    s.worstLatencyUs = std::max(s.worstLatencyUs, latency);
+    if (latency > device.deadlineUs) s.misses++;
+
+    // Keep the sampling phase; periods that were missed entirely are skipped.
+    // Event-driven devices just restart their timeout.
+    if (device.ready) {
+        device.releaseUs = now + device.periodUs;
+        return;
+    }
+    device.releaseUs += device.periodUs;
+    if (device.releaseUs <= now) {
+        device.releaseUs += ((now - device.releaseUs) / device.periodUs + 1) * device.periodUs;
+    }
+}
+
+// ssd1306_flusher.h
+#ifndef SSD1306_FLUSHER_H
+#define SSD1306_FLUSHER_H
+
+#include <Wire.h>
+#include "Adafruit_SSD1306.h"
+#include "config.h"
+
+// Sends the SSD1306 frame buffer one I2C write (WIRE_CHUNK bytes, under
+// a millisecond at 400 kHz) per step, for BusScheduler to slot between
+// sensor reads. The panel's address pointer carries on from one write to
+// the next, so a page only needs addressing once. Pages that match what
+// the panel already shows are skipped.
+class SSD1306Flusher {
+public:
+    static constexpr uint8_t PAGES = Config::SCREEN_HEIGHT / 8;
+    static constexpr uint8_t WIRE_CHUNK = 32;      // Data bytes per I2C write
+    static constexpr uint32_t BUS_HZ = 400000;
+
+    SSD1306Flusher(Adafruit_SSD1306& display, uint8_t address)
+        : display(display), address(address) {}
+
+    void start() {
+        page = 0;
+        offset = 0;
+    }
+
+    // Sends the next chunk of a changed page; true when nothing is left
+    bool step() {
+        const uint8_t* fb = display.getBuffer();
+        while (page < PAGES) {
+            const uint8_t* src = fb + page * Config::SCREEN_WIDTH;
+            uint8_t* sent = shown + page * Config::SCREEN_WIDTH;
+
+            if (offset == 0) {
+                if (memcmp(src, sent, Config::SCREEN_WIDTH) == 0) {
+                    page++;
+                    continue;
+                }
+                selectPage(page);
+            }
+
+            sendData(src + offset);
+            memcpy(sent + offset, src + offset, WIRE_CHUNK);
+            offset += WIRE_CHUNK;
+            if (offset >= Config::SCREEN_WIDTH) {
+                offset = 0;
+                page++;
+            }
+            return page >= PAGES;
+        }
+        return true;
+    }
+
+    // Bus time of the longest step (addressing plus one data write),
+    // 9 clocks per byte including the address byte
+    static constexpr uint32_t chunkCostUs() {
+        return (uint32_t)((8 + 2 + WIRE_CHUNK) * 9 * 1000000ULL / BUS_HZ);
+    }
+
+private:
+    Adafruit_SSD1306& display;
+    uint8_t address;
+    uint8_t page = PAGES;
+    uint8_t offset = 0;
+    uint8_t shown[Config::SCREEN_WIDTH * PAGES] = {};
+
+    void selectPage(uint8_t p) {
+        Wire.beginTransmission(address);
+        Wire.write((uint8_t)0x00);                      // Command stream
+        Wire.write((uint8_t)SSD1306_PAGEADDR);
+        Wire.write(p);
+        Wire.write(p);
+        Wire.write((uint8_t)SSD1306_COLUMNADDR);
+        Wire.write((uint8_t)0);
+        Wire.write((uint8_t)(Config::SCREEN_WIDTH - 1));
+        Wire.endTransmission();
+    }
+
+    void sendData(const uint8_t* data) {
+        Wire.beginTransmission(address);
+        Wire.write((uint8_t)0x40);                      // Data stream
+        Wire.write(data, WIRE_CHUNK);
+        Wire.endTransmission();
+    }
+};
+
+#endif // SSD1306_FLUSHER_H
+
+// bus_sim.cpp
+// Host-only: models bus occupancy while sensors share the I2C bus with a
+// display that repaints the full screen 20 times a second, and checks
+// sensor start jitter against a target. Runs the same load once with the
+// chunked flush and once with a blocking display() for comparison.
+//
+//   bus_sim [simulated seconds]
+#ifndef ARDUINO
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "clock.h"
+#include "bus_scheduler.h"
+
+namespace {
+
+constexpr uint64_t JITTER_TARGET_US = 1000;
+constexpr uint64_t FRAME_INTERVAL_US = 50000;
+constexpr uint8_t FLUSH_CHUNKS = 8 * 4;        // 8 pages of 128 bytes, 32 per write
+constexpr uint32_t CHUNK_COST_US = 945;         // SSD1306Flusher::chunkCostUs() at 400 kHz
+
+struct SimDevice {
+    const char* name;
+    uint64_t periodUs, deadlineUs;
+    uint32_t costUs;                            // Bus time per read
+};
+
+// INA219 shunt + bus registers, ADS1115 result, a TMP102 probe
+const SimDevice SIM_DEVICES[] = {
+    { "INA219", 2000, 500, 300 },
+    { "ADS1115", 8000, 1000, 250 },
+    { "TMP102", 100000, 5000, 200 },
+};
+
+// Returns the worst device jitter
+uint64_t simulate(bool chunked, double seconds) {
+    VirtualClock clock;
+    BusScheduler bus(clock);
+
+    for (const SimDevice& d : SIM_DEVICES) {
+        uint32_t cost = d.costUs;
+        bus.addDevice(d.name, d.periodUs, d.deadlineUs, [&clock, cost]() { clock.advance(cost); });
+    }
+
+    // A blocking flush is one chunk as long as the whole screen
+    uint8_t chunksLeft = 0;
+    uint32_t chunkCost = chunked ? CHUNK_COST_US : CHUNK_COST_US * FLUSH_CHUNKS;
+    auto step = [&]() {
+        clock.advance(chunkCost);
+        chunksLeft = chunked ? chunksLeft - 1 : 0;
+        return chunksLeft == 0;
+    };
+
+    PeriodicTimer frameTimer(FRAME_INTERVAL_US);
+    uint32_t framesRequested = 0, framesDropped = 0;
+    uint64_t busyUs = 0;
+    const uint64_t endUs = (uint64_t)(seconds * 1e6);
+
+    while (clock.nowUs() < endUs) {
+        if (frameTimer.due(clock)) {
+            framesRequested++;
+            if (bus.backgroundPending()) {
+                framesDropped++;       // The UI skips a frame while one is still going out
+            } else {
+                chunksLeft = FLUSH_CHUNKS;
+                bus.startBackground(step, chunkCost, chunked ? 20000 : 0);
+            }
+        }
+
+        uint64_t before = clock.nowUs();
+        if (bus.poll()) {
+            busyUs += clock.nowUs() - before;
+        } else if (!clock.advanceToNextDeadline()) {
+            break;
+        }
+    }
+
+    printf("%s flush: bus %.0f%% busy, %u/%u frames dropped\n",
+           chunked ? "chunked" : "blocking", 100.0 * busyUs / clock.nowUs(), framesDropped, framesRequested);
+
+    uint64_t worst = 0;
+    for (size_t i = 0; i < bus.deviceCount(); i++) {
+        const BusScheduler::Stats& s = bus.stats(i);
+        printf("  %-8s %7u reads  jitter mean %5.0f us  worst %6llu us  deadline misses %u\n",
+               bus.name(i), s.runs, s.runs ? (double)s.totalLatencyUs / s.runs : 0.0,
+               (unsigned long long)s.worstLatencyUs, s.misses);
+        worst = std::max(worst, s.worstLatencyUs);
+    }
+    return worst;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 600;
+
+    simulate(false, seconds);
+    uint64_t worst = simulate(true, seconds);
+
+    bool ok = worst <= JITTER_TARGET_US;
+    printf("worst sensor jitter %llu us, target %llu us: %s\n",
+           (unsigned long long)worst, (unsigned long long)JITTER_TARGET_US, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+#endif // ARDUINO
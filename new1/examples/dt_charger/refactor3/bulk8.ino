@@ -0,0 +1,723 @@
+// register_bus.h
+#ifndef REGISTER_BUS_H
+#define REGISTER_BUS_H
+
+#include <stdint.h>
+
+// 16-bit big-endian register access, the way the INA219, INA226 and
+// ADS1115 all talk: a write is the register pointer plus two bytes, a read
+// sets the pointer and then reads two bytes back.
+class RegisterBus {
+public:
+    virtual ~RegisterBus() = default;
+    virtual bool write16(uint8_t address, uint8_t reg, uint16_t value) = 0;
+    virtual bool read16(uint8_t address, uint8_t reg, uint16_t& value) = 0;
+};
+
+#ifdef ARDUINO
+#include <Wire.h>
+
+class WireRegisterBus : public RegisterBus {
+public:
+    explicit WireRegisterBus(TwoWire& wire) : wire(wire) {}
+
+    bool write16(uint8_t address, uint8_t reg, uint16_t value) override {
+        wire.beginTransmission(address);
+        wire.write(reg);
+        wire.write((uint8_t)(value >> 8));
+        wire.write((uint8_t)value);
+        return wire.endTransmission() == 0;
+    }
+
+    bool read16(uint8_t address, uint8_t reg, uint16_t& value) override {
+        wire.beginTransmission(address);
+        wire.write(reg);
+        if (wire.endTransmission(false) != 0) return false;
+        if (wire.requestFrom(address, (uint8_t)2) != 2) return false;
+        value = (uint16_t)wire.read() << 8;
+        value |= wire.read();
+        return true;
+    }
+
+private:
+    TwoWire& wire;
+};
+#endif
+
+#endif // REGISTER_BUS_H
+
+// power_monitors.h
+#ifndef POWER_MONITORS_H
+#define POWER_MONITORS_H
+
+#include <atomic>
+#include <stdint.h>
+#include "register_bus.h"
+#include "bus_scheduler.h"
+
+// Drivers for external converters on the shared I2C bus that never wait
+// for a conversion. Each service() collects the conversion started by the
+// previous one and starts the next in the same bus slot, so the chip is
+// always converting while the bus carries other traffic and the loop
+// keeps running.
+//
+// attach() hands service() to the BusScheduler. It is released by the
+// chip's ALERT/RDY pin when that is wired (onReady() from its ISR), or
+// otherwise by a timer set a little past the conversion time.
+class AsyncSensor {
+public:
+    AsyncSensor(RegisterBus& bus, uint8_t address) : bus(bus), address(address) {}
+    virtual ~AsyncSensor() = default;
+
+    virtual const char* name() const = 0;
+
+    // Configures the chip and starts the first conversion
+    virtual bool begin() = 0;
+
+    // Time one conversion takes with the configured settings
+    virtual uint32_t conversionUs() const = 0;
+
+    // Collects a finished conversion and starts the next; false if the
+    // chip wasn't done yet or the bus failed
+    bool service() { return collect(ready.exchange(false, std::memory_order_acquire)); }
+
+    // For the ALERT/RDY pin interrupt
+    void onReady() { ready.store(true, std::memory_order_release); }
+
+    // Registers service() with the scheduler; with usePin the conversion
+    // time only serves as a timeout in case an edge is lost
+    int attach(BusScheduler& scheduler, uint64_t deadlineUs, bool usePin);
+
+    uint32_t samples() const { return sampleCount; }
+    uint32_t busErrors() const { return errorCount; }
+
+protected:
+    RegisterBus& bus;
+    const uint8_t address;
+    uint32_t sampleCount = 0;
+    uint32_t errorCount = 0;
+
+    // signalled: the ready pin fired, so the status read can be skipped
+    virtual bool collect(bool signalled) = 0;
+
+    bool fail() {
+        errorCount++;
+        return false;
+    }
+
+private:
+    std::atomic<bool> ready{ false };
+};
+
+// Bus voltage and shunt current monitor
+class PowerMonitor : public AsyncSensor {
+public:
+    PowerMonitor(RegisterBus& bus, uint8_t address, float shuntOhms)
+        : AsyncSensor(bus, address), shuntOhms(shuntOhms) {}
+
+    float busVolts() const { return volts; }
+    float amps() const { return current; }
+
+protected:
+    const float shuntOhms;
+    float volts = 0.0f;
+    float current = 0.0f;
+};
+
+// INA219 in triggered shunt-and-bus mode. It has no ready pin, so it runs
+// on the timer; the CNVR bit in the bus voltage register says whether the
+// conversion is done.
+class Ina219 : public PowerMonitor {
+public:
+    static constexpr uint8_t REG_CONFIG = 0x00;
+    static constexpr uint8_t REG_SHUNT = 0x01;
+    static constexpr uint8_t REG_BUS = 0x02;
+    static constexpr uint16_t BUS_CNVR = 0x0002;
+
+    // 32 V bus range, +-320 mV shunt range, 12-bit shunt and bus
+    // conversions, triggered shunt and bus
+    static constexpr uint16_t CONFIG = 0x2000 | 0x1800 | 0x0180 | 0x0018 | 0x0003;
+    static constexpr uint32_t ADC_12BIT_US = 532;
+
+    using PowerMonitor::PowerMonitor;
+
+    const char* name() const override { return "INA219"; }
+    bool begin() override { return trigger(); }
+    uint32_t conversionUs() const override { return 2 * ADC_12BIT_US; }
+
+protected:
+    bool collect(bool signalled) override;
+
+private:
+    bool trigger() { return bus.write16(address, REG_CONFIG, CONFIG); }
+};
+
+// INA226 in triggered shunt-and-bus mode, with the conversion-ready flag
+// routed to ALERT
+class Ina226 : public PowerMonitor {
+public:
+    static constexpr uint8_t REG_CONFIG = 0x00;
+    static constexpr uint8_t REG_SHUNT = 0x01;
+    static constexpr uint8_t REG_BUS = 0x02;
+    static constexpr uint8_t REG_MASK_ENABLE = 0x06;
+    static constexpr uint16_t ALERT_ON_READY = 0x0400;   // CNVR
+    static constexpr uint16_t READY_FLAG = 0x0008;       // CVRF
+
+    // No averaging, 1.1 ms bus and shunt conversions, triggered shunt and bus
+    static constexpr uint16_t CONFIG = 0x4000 | 0x0100 | 0x0020 | 0x0003;
+    static constexpr uint32_t CONVERSION_US = 1100;
+
+    using PowerMonitor::PowerMonitor;
+
+    const char* name() const override { return "INA226"; }
+    bool begin() override;
+    uint32_t conversionUs() const override { return 2 * CONVERSION_US; }
+
+protected:
+    bool collect(bool signalled) override;
+
+private:
+    bool trigger() { return bus.write16(address, REG_CONFIG, CONFIG); }
+};
+
+// ADS1115 cycling single-shot conversions over its single-ended inputs.
+// Reading one channel's result and starting the next channel share a bus
+// slot, so the converter is never left idle between channels.
+class Ads1115 : public AsyncSensor {
+public:
+    static constexpr uint8_t MAX_CHANNELS = 4;
+    static constexpr uint8_t REG_CONVERSION = 0x00;
+    static constexpr uint8_t REG_CONFIG = 0x01;
+    static constexpr uint8_t REG_LO_THRESH = 0x02;
+    static constexpr uint8_t REG_HI_THRESH = 0x03;
+    static constexpr uint16_t OS = 0x8000;               // Write: start, read: idle
+
+    // +-4.096 V, single-shot, 860 SPS, ALERT/RDY after every conversion
+    static constexpr uint16_t CONFIG = 0x0200 | 0x0100 | 0x00E0;
+    static constexpr uint32_t CONVERSION_US = 1000000 / 860 + 1;
+    static constexpr float VOLTS_PER_LSB = 4.096f / 32768;
+
+    Ads1115(RegisterBus& bus, uint8_t address, uint8_t channels)
+        : AsyncSensor(bus, address),
+          channels(channels < 1 ? 1 : channels > MAX_CHANNELS ? MAX_CHANNELS : channels) {}
+
+    const char* name() const override { return "ADS1115"; }
+    bool begin() override;
+    uint32_t conversionUs() const override { return CONVERSION_US; }
+
+    uint8_t channelCount() const { return channels; }
+    float volts(uint8_t channel) const { return channel < channels ? readings[channel] : 0.0f; }
+
+protected:
+    bool collect(bool signalled) override;
+
+private:
+    const uint8_t channels;
+    uint8_t converting = 0;
+    float readings[MAX_CHANNELS] = {};
+
+    bool start(uint8_t channel) {
+        uint16_t mux = (uint16_t)(0x4 + channel) << 12;  // AINx against GND
+        return bus.write16(address, REG_CONFIG, OS | mux | CONFIG);
+    }
+};
+
+#endif // POWER_MONITORS_H
+
+// power_monitors.cpp
+#include "power_monitors.h"
+
+int AsyncSensor::attach(BusScheduler& scheduler, uint64_t deadlineUs, bool usePin) {
+    // These chips' internal oscillators are good to about 10%
+    uint64_t periodUs = conversionUs() + conversionUs() / 8;
+    auto transfer = [this]() { service(); };
+
+    // On a timer, each conversion starts when its slot runs, which may be
+    // up to the deadline after the release
+    if (!usePin) return scheduler.addDevice(name(), periodUs + deadlineUs, deadlineUs, transfer);
+
+    return scheduler.addDevice(name(), 2 * periodUs, deadlineUs, transfer,
+                               [this]() { return ready.load(std::memory_order_acquire); });
+}
+
+bool Ina219::collect(bool) {
+    uint16_t busReg, shuntReg;
+    if (!bus.read16(address, REG_BUS, busReg)) return fail();
+    if (!(busReg & BUS_CNVR)) return false;
+
+    // Retriggering clears CNVR, so the shunt result has to be read first
+    if (!bus.read16(address, REG_SHUNT, shuntReg)) return fail();
+    if (!trigger()) return fail();
+
+    volts = (busReg >> 3) * 0.004f;
+    current = (int16_t)shuntReg * 10e-6f / shuntOhms;
+    sampleCount++;
+    return true;
+}
+
+bool Ina226::begin() {
+    return bus.write16(address, REG_MASK_ENABLE, ALERT_ON_READY) && trigger();
+}
+
+bool Ina226::collect(bool signalled) {
+    if (!signalled) {
+        uint16_t flags;
+        if (!bus.read16(address, REG_MASK_ENABLE, flags)) return fail();
+        if (!(flags & READY_FLAG)) return false;
+    }
+
+    uint16_t shuntReg, busReg;
+    if (!bus.read16(address, REG_SHUNT, shuntReg) || !bus.read16(address, REG_BUS, busReg)) return fail();
+    if (!trigger()) return fail();
+
+    volts = busReg * 1.25e-3f;
+    current = (int16_t)shuntReg * 2.5e-6f / shuntOhms;
+    sampleCount++;
+    return true;
+}
+
+bool Ads1115::begin() {
+    // A non-negative low and negative high threshold turn ALERT into a
+    // conversion-ready pin
+    return bus.write16(address, REG_LO_THRESH, 0x0000) &&
+           bus.write16(address, REG_HI_THRESH, 0x8000) &&
+           start(converting);
+}
+
+bool Ads1115::collect(bool signalled) {
+    if (!signalled) {
+        uint16_t config;
+        if (!bus.read16(address, REG_CONFIG, config)) return fail();
+        if (!(config & OS)) return false;
+    }
+
+    uint16_t raw;
+    if (!bus.read16(address, REG_CONVERSION, raw)) return fail();
+    uint8_t done = converting;
+    converting = (converting + 1) % channels;
+    if (!start(converting)) return fail();
+
+    readings[done] = (int16_t)raw * VOLTS_PER_LSB;
+    sampleCount++;
+    return true;
+}
+
+// sim_register_bus.h
+#ifndef SIM_REGISTER_BUS_H
+#define SIM_REGISTER_BUS_H
+#ifndef ARDUINO
+
+#include <cmath>
+#include <functional>
+#include <map>
+#include <vector>
+#include "clock.h"
+#include "register_bus.h"
+#include "power_monitors.h"
+
+// Register-level stand-ins for the chips behind the power monitor drivers,
+// so the drivers run unchanged on a host. Conversions take their datasheet
+// time and latch the modelled signal as it was when they finished.
+class SimChip {
+public:
+    typedef std::function<float(uint64_t)> Signal;   // Value at a time in us
+    static constexpr uint64_t NO_EDGE = UINT64_MAX;
+
+    virtual ~SimChip() = default;
+    virtual uint16_t read(uint8_t reg) = 0;
+    virtual void write(uint8_t reg, uint16_t value) = 0;
+
+    // When the ready pin next goes active
+    uint64_t pinEdgeUs() const { return pinEdge; }
+    void clearPinEdge() { pinEdge = NO_EDGE; }
+
+protected:
+    explicit SimChip(const Clock& clock) : clock(clock) {}
+
+    const Clock& clock;
+    uint64_t doneUs = 0;
+    bool latched = true;
+    uint64_t pinEdge = NO_EDGE;
+
+    bool done() const { return clock.nowUs() >= doneUs; }
+
+    static uint16_t toRaw(float value, float lsb) {
+        float counts = value / lsb;
+        return (uint16_t)(int16_t)(counts < -32768 ? -32768 : counts > 32767 ? 32767 : lroundf(counts));
+    }
+};
+
+class SimIna219 : public SimChip {
+public:
+    SimIna219(const Clock& clock, float shuntOhms, Signal volts, Signal amps)
+        : SimChip(clock), shuntOhms(shuntOhms), volts(volts), amps(amps) {}
+
+    uint16_t read(uint8_t reg) override {
+        latch();
+        if (reg == Ina219::REG_CONFIG) return config;
+        if (reg == Ina219::REG_SHUNT) return shunt;
+        if (reg == Ina219::REG_BUS) return (uint16_t)((busMv / 4) << 3 | (converted ? Ina219::BUS_CNVR : 0));
+        return 0;
+    }
+
+    void write(uint8_t reg, uint16_t value) override {
+        if (reg != Ina219::REG_CONFIG) return;
+        config = value;
+        converted = false;
+        if ((value & 0x7) == 0x3) {
+            doneUs = clock.nowUs() + adcUs(value >> 7) + adcUs(value >> 3);
+            latched = false;
+        }
+    }
+
+private:
+    const float shuntOhms;
+    Signal volts, amps;
+    uint16_t config = 0x399F;
+    uint16_t shunt = 0;
+    uint16_t busMv = 0;
+    bool converted = false;
+
+    static uint32_t adcUs(uint16_t bits) {
+        static const uint32_t RESOLUTION_US[] = { 84, 148, 276, 532 };
+        return bits & 0x8 ? 532u << (bits & 0x7) : RESOLUTION_US[bits & 0x3];
+    }
+
+    void latch() {
+        if (latched || !done()) return;
+        shunt = toRaw(amps(doneUs) * shuntOhms, 10e-6f);
+        busMv = (uint16_t)lroundf(volts(doneUs) * 1000);
+        latched = converted = true;
+    }
+};
+
+class SimIna226 : public SimChip {
+public:
+    SimIna226(const Clock& clock, float shuntOhms, Signal volts, Signal amps)
+        : SimChip(clock), shuntOhms(shuntOhms), volts(volts), amps(amps) {}
+
+    uint16_t read(uint8_t reg) override {
+        latch();
+        if (reg == Ina226::REG_CONFIG) return config;
+        if (reg == Ina226::REG_SHUNT) return shunt;
+        if (reg == Ina226::REG_BUS) return bus;
+        if (reg == Ina226::REG_MASK_ENABLE) {
+            uint16_t value = enable | (readyFlag ? Ina226::READY_FLAG : 0);
+            readyFlag = false;   // Reading clears the flag
+            return value;
+        }
+        return 0;
+    }
+
+    void write(uint8_t reg, uint16_t value) override {
+        if (reg == Ina226::REG_MASK_ENABLE) enable = value & 0xFC01;
+        if (reg != Ina226::REG_CONFIG) return;
+        config = value;
+        readyFlag = false;
+        if ((value & 0x7) == 0x3) {
+            static const uint32_t CT_US[] = { 140, 204, 332, 588, 1100, 2116, 4156, 8244 };
+            static const uint32_t AVERAGES[] = { 1, 4, 16, 64, 128, 256, 512, 1024 };
+            uint32_t conversion = CT_US[(value >> 6) & 0x7] + CT_US[(value >> 3) & 0x7];
+            doneUs = clock.nowUs() + conversion * AVERAGES[(value >> 9) & 0x7];
+            latched = false;
+            pinEdge = enable & Ina226::ALERT_ON_READY ? doneUs : NO_EDGE;
+        }
+    }
+
+private:
+    const float shuntOhms;
+    Signal volts, amps;
+    uint16_t config = 0x4127;
+    uint16_t enable = 0;
+    uint16_t shunt = 0;
+    uint16_t bus = 0;
+    bool readyFlag = false;
+
+    void latch() {
+        if (latched || !done()) return;
+        shunt = toRaw(amps(doneUs) * shuntOhms, 2.5e-6f);
+        bus = toRaw(volts(doneUs), 1.25e-3f);
+        latched = readyFlag = true;
+    }
+};
+
+class SimAds1115 : public SimChip {
+public:
+    SimAds1115(const Clock& clock, std::vector<Signal> inputs) : SimChip(clock), inputs(inputs) {}
+
+    uint16_t read(uint8_t reg) override {
+        latch();
+        if (reg == Ads1115::REG_CONVERSION) return conversion;
+        if (reg == Ads1115::REG_CONFIG) return (config & ~Ads1115::OS) | (done() ? Ads1115::OS : 0);
+        if (reg == Ads1115::REG_LO_THRESH) return loThresh;
+        if (reg == Ads1115::REG_HI_THRESH) return hiThresh;
+        return 0;
+    }
+
+    void write(uint8_t reg, uint16_t value) override {
+        if (reg == Ads1115::REG_LO_THRESH) loThresh = value;
+        if (reg == Ads1115::REG_HI_THRESH) hiThresh = value;
+        if (reg != Ads1115::REG_CONFIG) return;
+        config = value;
+        if (value & Ads1115::OS) {
+            static const uint32_t SPS[] = { 8, 16, 32, 64, 128, 250, 475, 860 };
+            doneUs = clock.nowUs() + 1000000 / SPS[(value >> 5) & 0x7] + 1;
+            latched = false;
+            bool readyPin = (hiThresh & 0x8000) && !(loThresh & 0x8000) && (value & 0x3) != 0x3;
+            pinEdge = readyPin ? doneUs : NO_EDGE;
+        }
+    }
+
+private:
+    std::vector<Signal> inputs;
+    uint16_t config = 0x8583;
+    uint16_t conversion = 0;
+    uint16_t loThresh = 0x8000;
+    uint16_t hiThresh = 0x7FFF;
+
+    void latch() {
+        if (latched || !done()) return;
+        static const float FULL_SCALE[] = { 6.144f, 4.096f, 2.048f, 1.024f, 0.512f, 0.256f, 0.256f, 0.256f };
+        uint8_t mux = (config >> 12) & 0x7;
+        float value = mux >= 4 && mux - 4u < inputs.size() ? inputs[mux - 4](doneUs) : 0.0f;
+        conversion = toRaw(value, FULL_SCALE[(config >> 9) & 0x7] / 32768);
+        latched = true;
+    }
+};
+
+// Routes register accesses to the chips by address and charges each
+// transaction its time on the bus, 9 clocks per byte
+class SimRegisterBus : public RegisterBus {
+public:
+    SimRegisterBus(VirtualClock& clock, uint32_t busHz = 400000) : clock(clock), busHz(busHz) {}
+
+    void attach(uint8_t address, SimChip& chip) { chips[address] = &chip; }
+
+    bool write16(uint8_t address, uint8_t reg, uint16_t value) override {
+        SimChip* chip = transaction(address, 4);   // Address, pointer, two bytes
+        if (chip) chip->write(reg, value);
+        return chip != nullptr;
+    }
+
+    bool read16(uint8_t address, uint8_t reg, uint16_t& value) override {
+        SimChip* chip = transaction(address, 5);   // Address, pointer, address, two bytes
+        if (chip) value = chip->read(reg);
+        return chip != nullptr;
+    }
+
+    uint64_t busyUs() const { return busy; }
+    uint32_t transactions() const { return count; }
+
+private:
+    VirtualClock& clock;
+    const uint32_t busHz;
+    std::map<uint8_t, SimChip*> chips;
+    uint64_t busy = 0;
+    uint32_t count = 0;
+
+    SimChip* transaction(uint8_t address, uint32_t bytes) {
+        uint64_t us = (uint64_t)bytes * 9 * 1000000 / busHz;
+        clock.advance(us);
+        busy += us;
+        count++;
+        auto it = chips.find(address);
+        return it == chips.end() ? nullptr : it->second;
+    }
+};
+
+#endif // ARDUINO
+#endif // SIM_REGISTER_BUS_H
+
+// sensor_bench.cpp
+// Host-only: runs the power monitor drivers against the register-level
+// stand-ins and compares throughput with the same chips read the blocking
+// way (start a conversion, wait it out, read, next chip). Every reading is
+// checked against the modelled signal.
+//
+//   sensor_bench [simulated seconds]
+#ifndef ARDUINO
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "clock.h"
+#include "bus_scheduler.h"
+#include "power_monitors.h"
+#include "sim_register_bus.h"
+
+namespace {
+
+constexpr float SHUNT_OHMS = 0.05f;
+constexpr float VOLTS_TOLERANCE = 0.01f;
+constexpr float AMPS_TOLERANCE = 0.005f;
+constexpr uint64_t DEADLINE_US = 500;
+
+float wave(uint64_t us, float mean, float amplitude, float periodS, float phase = 0.0f) {
+    return mean + amplitude * sinf(2 * (float)M_PI * (us / 1e6f) / periodS + phase);
+}
+
+// Battery side on the INA226, supply side on the INA219, cell taps on the ADS1115
+float batteryVolts(uint64_t us) { return wave(us, 7.2f, 0.3f, 20.0f); }
+float batteryAmps(uint64_t us) { return wave(us, 1.0f, 0.1f, 7.0f); }
+float supplyVolts(uint64_t us) { return wave(us, 12.0f, 0.2f, 3.0f); }
+float supplyAmps(uint64_t us) { return wave(us, 0.6f, 0.05f, 5.0f); }
+float tapVolts(uint64_t us, int ch) { return wave(us, 1.0f + 0.6f * ch, 0.02f, 5.0f, (float)ch); }
+
+struct Rig {
+    VirtualClock clock;
+    SimRegisterBus bus{ clock };
+    SimIna226 simIna226{ clock, SHUNT_OHMS, batteryVolts, batteryAmps };
+    SimIna219 simIna219{ clock, SHUNT_OHMS, supplyVolts, supplyAmps };
+    SimAds1115 simAds1115{ clock, { [](uint64_t t) { return tapVolts(t, 0); },
+                                    [](uint64_t t) { return tapVolts(t, 1); },
+                                    [](uint64_t t) { return tapVolts(t, 2); },
+                                    [](uint64_t t) { return tapVolts(t, 3); } } };
+    Ina226 ina226{ bus, 0x40, SHUNT_OHMS };
+    Ina219 ina219{ bus, 0x41, SHUNT_OHMS };
+    Ads1115 ads1115{ bus, 0x48, 4 };
+
+    float worstVolts = 0, worstAmps = 0;
+    uint32_t seen226 = 0, seen219 = 0, seenAds = 0;
+
+    Rig() {
+        bus.attach(0x40, simIna226);
+        bus.attach(0x41, simIna219);
+        bus.attach(0x48, simAds1115);
+    }
+
+    bool begin() { return ina226.begin() && ina219.begin() && ads1115.begin(); }
+
+    // Compares any new readings with the signals now; they drift far less
+    // than the tolerance between conversion and collection
+    void check() {
+        uint64_t t = clock.nowUs();
+        auto compare = [](float& worst, float got, float expected) {
+            worst = std::max(worst, fabsf(got - expected));
+        };
+        if (ina226.samples() != seen226) {
+            seen226 = ina226.samples();
+            compare(worstVolts, ina226.busVolts(), batteryVolts(t));
+            compare(worstAmps, ina226.amps(), batteryAmps(t));
+        }
+        if (ina219.samples() != seen219) {
+            seen219 = ina219.samples();
+            compare(worstVolts, ina219.busVolts(), supplyVolts(t));
+            compare(worstAmps, ina219.amps(), supplyAmps(t));
+        }
+        if (ads1115.samples() != seenAds) {
+            // Channels are collected in turn, starting from the first
+            seenAds = ads1115.samples();
+            int ch = (seenAds - 1) % ads1115.channelCount();
+            compare(worstVolts, ads1115.volts(ch), tapVolts(t, ch));
+        }
+    }
+
+    void deliverPinEdges() {
+        SimChip* chips[] = { &simIna226, &simAds1115 };
+        AsyncSensor* sensors[] = { &ina226, &ads1115 };
+        for (int i = 0; i < 2; i++) {
+            if (chips[i]->pinEdgeUs() <= clock.nowUs()) {
+                chips[i]->clearPinEdge();
+                sensors[i]->onReady();
+            }
+            if (chips[i]->pinEdgeUs() != SimChip::NO_EDGE) clock.wakeAt(chips[i]->pinEdgeUs());
+        }
+    }
+};
+
+struct Result {
+    double ina226PerS, ina219PerS, adsChannelPerS;
+    double busPercent, cpuWaitPercent;
+    uint32_t errors;
+    float worstVolts, worstAmps;
+};
+
+Result summarize(const Rig& rig, const char* label, uint64_t cpuWaitUs) {
+    double s = rig.clock.nowUs() / 1e6;
+    Result r = {
+        rig.ina226.samples() / s, rig.ina219.samples() / s,
+        rig.ads1115.samples() / s / rig.ads1115.channelCount(),
+        100.0 * rig.bus.busyUs() / rig.clock.nowUs(), 100.0 * cpuWaitUs / rig.clock.nowUs(),
+        rig.ina226.busErrors() + rig.ina219.busErrors() + rig.ads1115.busErrors(),
+        rig.worstVolts, rig.worstAmps
+    };
+    printf("%-9s INA226 %6.0f/s  INA219 %6.0f/s  ADS1115 %5.0f/s per channel  "
+           "bus %4.1f%% busy  CPU %4.1f%% blocked  worst error %.4f V %.4f A\n",
+           label, r.ina226PerS, r.ina219PerS, r.adsChannelPerS, r.busPercent, r.cpuWaitPercent,
+           r.worstVolts, r.worstAmps);
+    return r;
+}
+
+// Conversion, wait, read, one chip at a time. The CPU is held for the
+// conversions as well as the bus transactions.
+Result runBlocking(double seconds) {
+    Rig rig;
+    rig.begin();
+    AsyncSensor* order[] = { &rig.ina226, &rig.ina219, &rig.ads1115 };
+    const uint64_t endUs = (uint64_t)(seconds * 1e6);
+    uint64_t waitUs = 0;
+
+    while (rig.clock.nowUs() < endUs) {
+        for (AsyncSensor* sensor : order) {
+            rig.clock.advance(sensor->conversionUs());
+            waitUs += sensor->conversionUs();
+            sensor->service();
+            rig.check();
+        }
+    }
+    return summarize(rig, "blocking", waitUs + rig.bus.busyUs());
+}
+
+// The drivers on the bus scheduler, released by their pins or timers
+Result runPipelined(double seconds) {
+    Rig rig;
+    BusScheduler scheduler(rig.clock);
+    rig.begin();
+    rig.ina226.attach(scheduler, DEADLINE_US, true);
+    rig.ina219.attach(scheduler, DEADLINE_US, false);
+    rig.ads1115.attach(scheduler, DEADLINE_US, true);
+    const uint64_t endUs = (uint64_t)(seconds * 1e6);
+
+    while (rig.clock.nowUs() < endUs) {
+        rig.deliverPinEdges();
+        if (scheduler.poll()) {
+            rig.check();
+        } else if (!rig.clock.advanceToNextDeadline()) {
+            break;
+        }
+    }
+
+    Result r = summarize(rig, "pipelined", rig.bus.busyUs());
+    for (size_t i = 0; i < scheduler.deviceCount(); i++) {
+        const BusScheduler::Stats& s = scheduler.stats(i);
+        printf("  %-8s %7u slots  latency mean %4.0f us  worst %4llu us  deadline misses %u\n",
+               scheduler.name(i), s.runs, s.runs ? (double)s.totalLatencyUs / s.runs : 0.0,
+               (unsigned long long)s.worstLatencyUs, s.misses);
+    }
+    return r;
+}
+
+bool accurate(const Result& r) {
+    return r.errors == 0 && r.worstVolts <= VOLTS_TOLERANCE && r.worstAmps <= AMPS_TOLERANCE;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 60;
+
+    Result blocking = runBlocking(seconds);
+    Result pipelined = runPipelined(seconds);
+
+    double gain = pipelined.adsChannelPerS / blocking.adsChannelPerS;
+    bool faster = pipelined.ina226PerS > blocking.ina226PerS && pipelined.ina219PerS > blocking.ina219PerS &&
+                  gain > 1.0;
+    bool ok = faster && accurate(blocking) && accurate(pipelined);
+    printf("ADS1115 channel rate x%.1f, readings within %.3f V / %.3f A: %s\n",
+           gain, VOLTS_TOLERANCE, AMPS_TOLERANCE, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+#endif // ARDUINO
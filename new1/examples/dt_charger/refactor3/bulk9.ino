@@ -0,0 +1,438 @@
+// memory_profiler.h
+#ifndef MEMORY_PROFILER_H
+#define MEMORY_PROFILER_H
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+// Where the numbers come from: the ESP-IDF heap and FreeRTOS watermarks on
+// the target, counted allocations and painted thread stacks on a host
+class MemorySource {
+public:
+    struct Heap {
+        uint32_t usedBytes;
+        uint32_t freeBytes;
+        uint32_t largestBlock;   // Biggest single allocation that would succeed
+    };
+
+    virtual ~MemorySource() = default;
+    virtual Heap heap() = 0;
+
+    // Least free stack the task has had since it started, in bytes
+    virtual uint32_t stackLowWater(void* task) = 0;
+};
+
+#ifdef ARDUINO
+class EspMemorySource : public MemorySource {
+public:
+    Heap heap() override;
+    uint32_t stackLowWater(void* task) override;
+};
+#else
+// Host builds of the firmware: the C library's own heap counters. Host
+// threads have no watermark to read, so no task ever reports a low stack.
+class MallocMemorySource : public MemorySource {
+public:
+    Heap heap() override;
+    uint32_t stackLowWater(void*) override { return UINT32_MAX; }
+};
+#endif
+
+// Attributes heap and stack use to whatever the firmware is doing: each
+// screen (or other phase) is a scope, entered with enterScope().
+//
+// Per scope it keeps the highest heap use and the smallest largest-free
+// block seen while that scope was active, and how far each task's stack
+// watermark dropped during it. Watermarks only ever fall, so a drop is
+// charged to the scope that was active when it was first seen; sample()
+// right after heavy work keeps that attribution tight.
+//
+// A report goes to the sink on demand and once whenever a scope exceeds
+// its budget or a task's stack falls below its floor.
+class MemoryProfiler {
+public:
+    typedef std::function<void(const char*)> LineSink;
+
+    struct Budget {
+        uint32_t maxUsedBytes;
+        uint32_t minLargestBlock;   // Fragmentation limit
+    };
+
+    MemoryProfiler(MemorySource& source, LineSink sink) : source(source), sink(sink) {}
+
+    // minStackFree: report when the task's low-water mark falls below this
+    void addTask(const char* name, void* handle, uint32_t minStackFree);
+
+    void setBudget(const char* scope, const Budget& budget);
+
+    // Samples first, so the scope being left is charged for its last frame
+    void enterScope(const char* scope);
+
+    void sample();
+    void report(const char* reason = "on demand");
+
+    // True once any scope or task has crossed its limit
+    bool overBudget() const { return crossed; }
+
+private:
+    struct Task {
+        const char* name;
+        void* handle;
+        uint32_t minStackFree;
+        uint32_t lowWater;
+        bool flagged;
+    };
+
+    struct Scope {
+        const char* name;
+        Budget budget;
+        uint32_t samples;
+        uint32_t peakUsed;
+        uint32_t lowFree;
+        uint32_t lowLargest;
+        std::vector<uint32_t> stackDrop;   // Per task, bytes
+        bool flagged;
+    };
+
+    MemorySource& source;
+    LineSink sink;
+    std::vector<Task> tasks;
+    std::vector<Scope> scopes;
+    int current = -1;
+    bool crossed = false;
+
+    int scopeIndex(const char* name);
+    bool overBudget(const Scope& scope) const;
+    void print(const char* format, ...);
+};
+
+#endif // MEMORY_PROFILER_H
+
+// memory_profiler.cpp
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "memory_profiler.h"
+
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+MemorySource::Heap EspMemorySource::heap() {
+    Heap h;
+    h.freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    h.usedBytes = heap_caps_get_total_size(MALLOC_CAP_8BIT) - h.freeBytes;
+    h.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    return h;
+}
+
+// ESP-IDF stacks are byte arrays, so the watermark is already in bytes
+uint32_t EspMemorySource::stackLowWater(void* task) {
+    return uxTaskGetStackHighWaterMark(static_cast<TaskHandle_t>(task));
+}
+#else
+#include <malloc.h>
+
+// No fragmentation model: all free arena space counts as one block
+MemorySource::Heap MallocMemorySource::heap() {
+    struct mallinfo2 info = mallinfo2();
+    return { (uint32_t)info.uordblks, (uint32_t)info.fordblks, (uint32_t)info.fordblks };
+}
+#endif
+
+void MemoryProfiler::addTask(const char* name, void* handle, uint32_t minStackFree) {
+    tasks.push_back({ name, handle, minStackFree, source.stackLowWater(handle), false });
+    for (Scope& s : scopes) s.stackDrop.push_back(0);
+}
+
+int MemoryProfiler::scopeIndex(const char* name) {
+    for (size_t i = 0; i < scopes.size(); i++) {
+        if (strcmp(scopes[i].name, name) == 0) return i;
+    }
+    scopes.push_back({ name, { UINT32_MAX, 0 }, 0, 0, UINT32_MAX, UINT32_MAX,
+                       std::vector<uint32_t>(tasks.size(), 0), false });
+    return scopes.size() - 1;
+}
+
+void MemoryProfiler::setBudget(const char* scope, const Budget& budget) {
+    scopes[scopeIndex(scope)].budget = budget;
+}
+
+void MemoryProfiler::enterScope(const char* scope) {
+    if (current >= 0) sample();
+    current = scopeIndex(scope);
+    sample();
+}
+
+bool MemoryProfiler::overBudget(const Scope& s) const {
+    return s.samples && (s.peakUsed > s.budget.maxUsedBytes || s.lowLargest < s.budget.minLargestBlock);
+}
+
+void MemoryProfiler::sample() {
+    if (current < 0) return;
+    Scope& s = scopes[current];
+    MemorySource::Heap h = source.heap();
+
+    s.samples++;
+    if (h.usedBytes > s.peakUsed) s.peakUsed = h.usedBytes;
+    if (h.freeBytes < s.lowFree) s.lowFree = h.freeBytes;
+    if (h.largestBlock < s.lowLargest) s.lowLargest = h.largestBlock;
+
+    const char* reason = nullptr;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        Task& t = tasks[i];
+        uint32_t low = source.stackLowWater(t.handle);
+        if (low < t.lowWater) {
+            s.stackDrop[i] += t.lowWater - low;
+            t.lowWater = low;
+        }
+        if (!t.flagged && t.lowWater < t.minStackFree) {
+            t.flagged = true;
+            reason = "stack below floor";
+        }
+    }
+    if (!s.flagged && overBudget(s)) {
+        s.flagged = true;
+        reason = "scope over budget";
+    }
+
+    if (reason) {
+        crossed = true;
+        report(reason);
+    }
+}
+
+void MemoryProfiler::print(const char* format, ...) {
+    char line[96];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    sink(line);
+}
+
+void MemoryProfiler::report(const char* reason) {
+    print("memory report (%s), in scope %s", reason, current >= 0 ? scopes[current].name : "-");
+
+    print("%-10s %8s %8s %8s %4s %8s", "scope", "peak use", "low free", "largest", "frag", "budget");
+    for (const Scope& s : scopes) {
+        if (!s.samples) continue;
+        // Share of free heap that can't be had in one block
+        unsigned frag = s.lowFree ? 100 - (uint64_t)s.lowLargest * 100 / s.lowFree : 0;
+        char budget[12] = "-";
+        if (s.budget.maxUsedBytes != UINT32_MAX) snprintf(budget, sizeof(budget), "%lu", (unsigned long)s.budget.maxUsedBytes);
+        print("%-10s %8lu %8lu %8lu %3u%% %8s%s", s.name, (unsigned long)s.peakUsed, (unsigned long)s.lowFree,
+              (unsigned long)s.lowLargest, frag, budget, overBudget(s) ? " OVER" : "");
+    }
+
+    for (size_t i = 0; i < tasks.size(); i++) {
+        const Task& t = tasks[i];
+        print("stack %-10s %6lu bytes free at worst, floor %lu%s", t.name, (unsigned long)t.lowWater,
+              (unsigned long)t.minStackFree, t.lowWater < t.minStackFree ? " LOW" : "");
+        for (const Scope& s : scopes) {
+            if (s.stackDrop[i]) print("  %-10s grew it %lu bytes", s.name, (unsigned long)s.stackDrop[i]);
+        }
+    }
+}
+
+// memory_budget.cpp
+// Host-only: runs the host-buildable subsystems as profiler scopes and
+// enforces their memory budgets, the same way the firmware reports each
+// screen. Heap use is counted by replacing operator new/delete, against a
+// heap the size of the ESP32's; each scope runs on a thread whose stack
+// is painted first, like a FreeRTOS task, so its depth can be read back.
+// The host has no fragmentation model: the largest block is all that's free.
+// Split the sketches out as replay.cpp describes, then from /tmp/dt_host:
+//   g++ -std=c++17 -O2 -Wall -I. memory_budget.cpp memory_profiler.cpp charger_controller.cpp history_manager.cpp safety_interlock.cpp bus_scheduler.cpp power_monitors.cpp -lpthread -o memory_budget
+//
+//   memory_budget
+#ifndef ARDUINO
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <pthread.h>
+#include "clock.h"
+#include "bus_scheduler.h"
+#include "history_manager.h"
+#include "charger_controller.h"
+#include "safety_interlock.h"
+#include "power_monitors.h"
+#include "sim_register_bus.h"
+#include "memory_profiler.h"
+
+static uint32_t pwmDuty = 0;
+void ledcWrite(uint8_t channel, uint32_t duty) { pwmDuty = duty; }
+uint32_t ledcRead(uint8_t channel) { return pwmDuty; }
+
+namespace {
+
+constexpr uint32_t TARGET_HEAP_BYTES = 300 * 1024;   // Roughly what an ESP32 sketch has free at boot
+constexpr size_t TASK_STACK_BYTES = 32 * 1024;
+constexpr uint8_t STACK_PAINT = 0xA5;
+
+std::atomic<uint64_t> heapUsed{ 0 };
+
+}  // namespace
+
+// Each block carries its size in front so delete can count it back
+void* operator new(size_t size) {
+    size_t* block = static_cast<size_t*>(malloc(size + sizeof(size_t)));
+    if (!block) throw std::bad_alloc();
+    *block = size;
+    heapUsed += size;
+    return block + 1;
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    size_t* block = static_cast<size_t*>(p) - 1;
+    heapUsed -= *block;
+    free(block);
+}
+
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+namespace {
+
+// A thread with a stack we own and paint, standing in for a FreeRTOS task
+struct PaintedTask {
+    uint8_t* stack;
+    pthread_t thread;
+    void (*body)(MemoryProfiler&);
+    MemoryProfiler* profiler;
+
+    PaintedTask() : stack(static_cast<uint8_t*>(aligned_alloc(4096, TASK_STACK_BYTES))) {
+        memset(stack, STACK_PAINT, TASK_STACK_BYTES);
+    }
+    ~PaintedTask() { ::free(stack); }
+
+    void run(void (*fn)(MemoryProfiler&), MemoryProfiler& p) {
+        body = fn;
+        profiler = &p;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstack(&attr, stack, TASK_STACK_BYTES);
+        pthread_create(&thread, &attr, [](void* arg) -> void* {
+            auto* task = static_cast<PaintedTask*>(arg);
+            task->body(*task->profiler);
+            return nullptr;
+        }, this);
+        pthread_join(thread, nullptr);
+        pthread_attr_destroy(&attr);
+    }
+
+    // Stacks grow down, so untouched paint is at the low end
+    uint32_t untouched() const {
+        uint32_t n = 0;
+        while (n < TASK_STACK_BYTES && stack[n] == STACK_PAINT) n++;
+        return n;
+    }
+};
+
+class HostMemorySource : public MemorySource {
+public:
+    Heap heap() override {
+        uint32_t used = (uint32_t)heapUsed.load();
+        uint32_t free = used < TARGET_HEAP_BYTES ? TARGET_HEAP_BYTES - used : 0;
+        return { used, free, free };
+    }
+
+    uint32_t stackLowWater(void* task) override {
+        return static_cast<PaintedTask*>(task)->untouched();
+    }
+};
+
+// A two-hour charge through history and the controller, one tick a second
+void chargeSession(MemoryProfiler& profiler) {
+    VirtualClock clock;
+    HistoryManager history(clock);
+    SafetyInterlock interlock;
+    ChargerController charger(clock, history, interlock);
+    interlock.begin();
+    charger.begin();
+    charger.startCharging();
+
+    for (int s = 0; s < 2 * 3600; s++) {
+        clock.advance(1000000);
+        SensorManager::SensorData data = { 5.6f + s * 1e-4f, 1.0f, 25.0f + s * 1e-3f, 25.0f };
+        interlock.onSample(SensorManager::temperatureToRaw(data.temperature),
+                           SensorManager::currentToRaw(data.current));
+        history.addPoint(data);
+        charger.update(data);
+        // What the graph screen pulls every frame
+        if (s % 60 == 0) {
+            std::vector<HistoryPoint> visible = history.getVisibleHistory();
+            profiler.sample();
+        }
+    }
+}
+
+// Ten seconds of the power monitor on the bus scheduler
+void powerMonitor(MemoryProfiler& profiler) {
+    VirtualClock clock;
+    SimRegisterBus bus(clock);
+    SimIna226 chip(clock, 0.05f, [](uint64_t) { return 7.2f; }, [](uint64_t) { return 1.0f; });
+    bus.attach(0x40, chip);
+    Ina226 monitor(bus, 0x40, 0.05f);
+    BusScheduler scheduler(clock);
+    monitor.begin();
+    monitor.attach(scheduler, 500, true);
+
+    while (clock.nowUs() < 10000000) {
+        if (chip.pinEdgeUs() <= clock.nowUs()) {
+            chip.clearPinEdge();
+            monitor.onReady();
+        }
+        if (chip.pinEdgeUs() != SimChip::NO_EDGE) clock.wakeAt(chip.pinEdgeUs());
+        if (!scheduler.poll() && !clock.advanceToNextDeadline()) break;
+        if (monitor.samples() % 1000 == 0) profiler.sample();
+    }
+}
+
+// Stack budgets include glibc's thread descriptor and TLS, which sit at
+// the top of the stack we hand it, a few KB a FreeRTOS task doesn't pay
+struct Scope {
+    const char* name;
+    void (*body)(MemoryProfiler&);
+    MemoryProfiler::Budget heap;
+    uint32_t maxStackBytes;
+};
+
+const Scope SCOPES[] = {
+    { "charge", chargeSession, { 16 * 1024, 64 * 1024 }, 16 * 1024 },
+    { "monitor", powerMonitor, { 8 * 1024, 64 * 1024 }, 12 * 1024 },
+};
+
+}  // namespace
+
+int main() {
+    HostMemorySource source;
+    MemoryProfiler profiler(source, [](const char* line) { puts(line); });
+
+    // One task per scope, so each stack depth is that scope's alone
+    constexpr size_t COUNT = sizeof(SCOPES) / sizeof(SCOPES[0]);
+    PaintedTask tasks[COUNT];
+    for (size_t i = 0; i < COUNT; i++) {
+        profiler.addTask(SCOPES[i].name, &tasks[i], TASK_STACK_BYTES - SCOPES[i].maxStackBytes);
+        profiler.setBudget(SCOPES[i].name, SCOPES[i].heap);
+    }
+
+    for (size_t i = 0; i < COUNT; i++) {
+        profiler.enterScope(SCOPES[i].name);
+        tasks[i].run(SCOPES[i].body, profiler);
+        profiler.sample();
+    }
+
+    profiler.report("end of run");
+    bool ok = !profiler.overBudget();
+    printf("%s\n", ok ? "within budget" : "OVER BUDGET");
+    return ok ? 0 : 1;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Builds IconAtlasData.h from the ASCII icon sources in icons/icons.txt.
+
+Every icon is emitted twice:
+  - 1 bpp in the SSD1306 page layout: for each 8-row page, one byte per
+    column, bit 0 = top row,
+  - RGB565, row-major, colours big-endian,
+and each stream is packed into runs: a control byte with bit 7 set means
+the next item repeats (c & 0x7F) + 1 times, bit 7 clear means c + 1
+literal items follow. Runs may cross rows and pages.
+
+Usage: tools/make_icon_atlas.py [icons/icons.txt] [IconAtlasData.h]
+"""
+
+import os
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SKETCH = os.path.dirname(HERE)
+
+
+def parse(path):
+    palette = {'.': 0x0000}
+    icons = []
+    current = None
+    with open(path) as f:
+        for lineno, raw in enumerate(f, 1):
+            line = raw.split('#', 1)[0].strip()
+            if not line:
+                continue
+            words = line.split()
+            if words[0] == 'palette':
+                palette[words[1]] = int(words[2], 16)
+            elif words[0] == 'icon':
+                current = (words[1].upper(), [])
+                icons.append(current)
+            elif current is None:
+                sys.exit('%s:%d: pixels before the first icon' % (path, lineno))
+            else:
+                rows = current[1]
+                if rows and len(line) != len(rows[0]):
+                    sys.exit('%s:%d: ragged row in %s' % (path, lineno, current[0]))
+                rows.append(line)
+
+    for name, rows in icons:
+        for row in rows:
+            for ch in row:
+                if ch not in palette:
+                    sys.exit('%s: unknown colour %r in %s' % (path, ch, name))
+    return palette, icons
+
+
+def pack(items, item_bytes, min_run):
+    """Repeats shorter than min_run are cheaper left inside a literal block."""
+    def repeats_at(i):
+        return i + min_run <= len(items) and all(items[j] == items[i] for j in range(i, i + min_run))
+
+    out = []
+    i = 0
+    while i < len(items):
+        run = 1
+        while i + run < len(items) and items[i + run] == items[i] and run < 128:
+            run += 1
+        if run >= min_run:
+            out.append(0x80 | (run - 1))
+            out += item_bytes(items[i])
+            i += run
+            continue
+        # Literal block up to the next repeat
+        start = i
+        while i < len(items) and i - start < 128:
+            if repeats_at(i):
+                break
+            i += 1
+        out.append(i - start - 1)
+        for item in items[start:i]:
+            out += item_bytes(item)
+    return out
+
+
+def encode_mono(rows):
+    w, h = len(rows[0]), len(rows)
+    columns = []
+    for page in range(0, h, 8):
+        for x in range(w):
+            byte = 0
+            for bit in range(min(8, h - page)):
+                if rows[page + bit][x] != '.':
+                    byte |= 1 << bit
+            columns.append(byte)
+    return pack(columns, lambda b: [b], 3)
+
+
+def encode_rgb565(rows, palette):
+    pixels = [palette[ch] for row in rows for ch in row]
+    return pack(pixels, lambda p: [p >> 8, p & 0xFF], 2)
+
+
+def c_bytes(data, indent='    '):
+    lines = []
+    for i in range(0, len(data), 12):
+        lines.append(indent + ', '.join('0x%02X' % b for b in data[i:i + 12]) + ',')
+    return '\n'.join(lines)
+
+
+def main():
+    src = sys.argv[1] if len(sys.argv) > 1 else os.path.join(SKETCH, 'icons', 'icons.txt')
+    dst = sys.argv[2] if len(sys.argv) > 2 else os.path.join(SKETCH, 'IconAtlasData.h')
+    palette, icons = parse(src)
+
+    mono, rgb, mono_index, rgb_index = [], [], [], []
+    raw_mono = raw_rgb = 0
+    for name, rows in icons:
+        w, h = len(rows[0]), len(rows)
+        mono_index.append((name, len(mono), w, h))
+        rgb_index.append((name, len(rgb), w, h))
+        mono += encode_mono(rows)
+        rgb += encode_rgb565(rows, palette)
+        raw_mono += w * ((h + 7) // 8)
+        raw_rgb += w * h * 2
+
+    out = []
+    out.append('// Generated by tools/make_icon_atlas.py from icons/icons.txt - do not edit')
+    out.append('// 1 bpp: %d bytes (%d raw), RGB565: %d bytes (%d raw)'
+               % (len(mono), raw_mono, len(rgb), raw_rgb))
+    out.append('')
+    out.append('#ifndef ICON_ATLAS_DATA_H')
+    out.append('#define ICON_ATLAS_DATA_H')
+    out.append('')
+    out.append('enum IconId : uint8_t {')
+    for name, _ in icons:
+        out.append('    ICON_%s,' % name)
+    out.append('    ICON_COUNT,')
+    out.append('    ICON_NONE = 0xFF')
+    out.append('};')
+    out.append('')
+    out.append('#define ICON_MAX_WIDTH %d' % max(len(rows[0]) for _, rows in icons))
+    out.append('')
+    out.append('static const uint8_t ICON_MONO_DATA[] = {')
+    out.append(c_bytes(mono))
+    out.append('};')
+    out.append('')
+    out.append('static const uint8_t ICON_RGB565_DATA[] = {')
+    out.append(c_bytes(rgb))
+    out.append('};')
+    out.append('')
+    for label, index in (('MONO', mono_index), ('RGB565', rgb_index)):
+        out.append('static const IconInfo ICON_%s[ICON_COUNT] = {' % label)
+        for name, offset, w, h in index:
+            out.append('    { ICON_%s_DATA + %d, %d, %d },   // %s' % (label, offset, w, h, name))
+        out.append('};')
+        out.append('')
+    out.append('#endif // ICON_ATLAS_DATA_H')
+
+    with open(dst, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -1,5 +1,7 @@
 #include "UI_Framework.h"
 #include <Wire.h>
+#include <atomic>
+#include <esp_timer.h>
 
 // Pin definitions
 #define VOLTAGE_PIN 36    // ADC pin for voltage measurement
@@ -7,14 +9,27 @@
 #define TEMP_PIN 34      // ADC pin for temperature measurement
 #define PWM_PIN 25       // PWM output for charge control
 
+// Cell tap multiplexer (CD74HC4051): tap k carries cells 1..k
+#define MUX_S0_PIN 26
+#define MUX_S1_PIN 27
+#define MUX_S2_PIN 14
+#define MUX_ADC_PIN 33    // Mux common output, ADC1
+#define MUX_SETTLE_US 200 // Divider + mux RC settling after switching taps
+#define MUX_OVERSAMPLE 8
+
 // Battery parameters
 #define CELL_COUNT 4
 #define CHARGE_CURRENT_MA 1000
 #define TRICKLE_CURRENT_MA 50
 #define CELL_VOLTAGE_MAX 1.45
 #define CELL_VOLTAGE_MIN 1.0
+#define CELL_VOLTAGE_ABORT 1.60     // A cell this high isn't taking charge
+#define CELL_CHECK_DELAY_MS 60000   // Low cells are only judged after this much charging
 #define CAPACITY_MAH 2000
 
+// Divider ratio in front of the mux for each tap; adjust to your resistors
+const float TAP_DIVIDER[CELL_COUNT] = { 1.0f, 2.0f, 2.0f, 3.0f };
+
 // Charger states
 enum ChargerState {
     IDLE,
@@ -34,6 +49,7 @@ float temperature = 0.0f;
 float capacityMah = 0.0f;
 unsigned long chargeStartTime = 0;
 bool charging = false;
+const char* errorText = "Error - Overtemp";
 
 // Voltage measurement history for -dV detection
 const int VOLTAGE_HISTORY_SIZE = 60;  // 1 minute history at 1s intervals
@@ -46,21 +62,125 @@ void stopCharging();
 float calculateCapacity();
 const char* getStateString();
 float getBatteryTemperature();
+bool cellsHealthy(const float cells[CELL_COUNT], unsigned long chargingMs);
+
+// Per-cell voltages, scanned through the tap mux. Each tap is selected,
+// left to settle for MUX_SETTLE_US, then oversampled; a cell is the
+// difference between adjacent taps. The steps run as esp_timer callbacks
+// rather than from loop(), so a full pass (about 1 ms for four cells)
+// finishes well inside one 100 ms charger tick however long the display
+// takes to refresh.
+class CellScanner {
+private:
+    static constexpr float FILTER_ALPHA = 0.25f;   // Per-cell low-pass, per scan
+
+    esp_timer_handle_t timer = nullptr;
+    std::atomic<bool> scanning{false};
+    std::atomic<uint32_t> sequence{0};    // Odd while a result is being written
+    uint8_t tap = 0;
+    float tapVoltages[CELL_COUNT];
+    float filtered[CELL_COUNT];
+
+    static void onTimer(void* arg) {
+        static_cast<CellScanner*>(arg)->sampleTap();
+    }
+
+    void selectTap(uint8_t t) {
+        digitalWrite(MUX_S0_PIN, t & 1);
+        digitalWrite(MUX_S1_PIN, (t >> 1) & 1);
+        digitalWrite(MUX_S2_PIN, (t >> 2) & 1);
+    }
+
+    void sampleTap() {
+        uint32_t sumMv = 0;
+        for(int i = 0; i < MUX_OVERSAMPLE; i++) {
+            sumMv += analogReadMilliVolts(MUX_ADC_PIN);
+        }
+        tapVoltages[tap] = sumMv / (1000.0f * MUX_OVERSAMPLE) * TAP_DIVIDER[tap];
+
+        if(++tap < CELL_COUNT) {
+            selectTap(tap);
+            esp_timer_start_once(timer, MUX_SETTLE_US);
+            return;
+        }
+        publish();
+        scanning = false;
+    }
+
+    void publish() {
+        bool first = sequence.load(std::memory_order_relaxed) == 0;
+        sequence.fetch_add(1, std::memory_order_acq_rel);
+        for(int i = 0; i < CELL_COUNT; i++) {
+            float cell = tapVoltages[i] - (i > 0 ? tapVoltages[i - 1] : 0.0f);
+            filtered[i] = first ? cell : filtered[i] + FILTER_ALPHA * (cell - filtered[i]);
+        }
+        sequence.fetch_add(1, std::memory_order_release);
+    }
+
+public:
+    void begin() {
+        pinMode(MUX_S0_PIN, OUTPUT);
+        pinMode(MUX_S1_PIN, OUTPUT);
+        pinMode(MUX_S2_PIN, OUTPUT);
+
+        esp_timer_create_args_t args = {};
+        args.callback = &CellScanner::onTimer;
+        args.arg = this;
+        args.name = "cellscan";
+        esp_timer_create(&args, &timer);
+    }
+
+    // Kicks off a pass unless the previous one is still running
+    void startScan() {
+        if(!timer || scanning.exchange(true)) return;
+        tap = 0;
+        selectTap(0);
+        esp_timer_start_once(timer, MUX_SETTLE_US);
+    }
+
+    // Copies the latest filtered cell voltages; false before the first pass
+    bool read(float out[CELL_COUNT]) const {
+        uint32_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            memcpy(out, filtered, sizeof(filtered));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while((before & 1) || before != after);
+        return before != 0;
+    }
+};
+
+CellScanner cellScanner;
 
 class BatteryWidget : public Widget {
 private:
     float cellVoltages[CELL_COUNT];
+    bool haveCells;
     float totalVoltage;
     float current;
     float percentage;
+
+    static float cellPercentage(float cellVoltage) {
+        float p = (cellVoltage - CELL_VOLTAGE_MIN) / (CELL_VOLTAGE_MAX - CELL_VOLTAGE_MIN) * 100;
+        return constrain(p, 0, 100);
+    }
     
 public:
     BatteryWidget(int16_t x, int16_t y, int16_t w, int16_t h)
-        : Widget(x, y, w, h), totalVoltage(0), current(0), percentage(0) {
+        : Widget(x, y, w, h), haveCells(false), totalVoltage(0), current(0), percentage(0) {
         for(int i = 0; i < CELL_COUNT; i++) {
             cellVoltages[i] = 0;
         }
     }
+
+    void setCellVoltages(const float cells[CELL_COUNT]) {
+        for(int i = 0; i < CELL_COUNT; i++) {
+            cellVoltages[i] = cells[i];
+        }
+        haveCells = true;
+        dirty = true;
+    }
     
     void updateValues(float voltage, float curr) {
         totalVoltage = voltage;
@@ -77,15 +197,27 @@ public:
         display.drawRect(x, y + 2, width - 10, height - 4, WHITE);
         display.fillRect(x + width - 10, y + height/3, 10, height/3, WHITE);
         
-        // Draw fill level
-        int fillWidth = ((width - 14) * percentage) / 100;
-        display.fillRect(x + 2, y + 4, fillWidth, height - 8, WHITE);
+        if(haveCells) {
+            // One bar per cell, so a weak cell stands out from the pack
+            int innerWidth = width - 14;
+            int innerHeight = height - 8;
+            for(int i = 0; i < CELL_COUNT; i++) {
+                int x0 = x + 2 + innerWidth * i / CELL_COUNT;
+                int x1 = x + 2 + innerWidth * (i + 1) / CELL_COUNT - 1;
+                int fillHeight = innerHeight * cellPercentage(cellVoltages[i]) / 100;
+                display.fillRect(x0, y + 4 + innerHeight - fillHeight, x1 - x0, fillHeight, WHITE);
+            }
+        } else {
+            // Draw fill level
+            int fillWidth = ((width - 14) * percentage) / 100;
+            display.fillRect(x + 2, y + 4, fillWidth, height - 8, WHITE);
+        }
         
-        // Draw voltage and current
+        // Draw voltage and current; inverse so it reads over any fill
         char buffer[32];
         snprintf(buffer, sizeof(buffer), "%.2fV %.0fmA", totalVoltage, current);
         display.setCursor(x + 2, y + height/2 - 4);
-        display.setTextColor(percentage > 50 ? BLACK : WHITE);
+        display.setTextColor(SSD1306_INVERSE);
         display.print(buffer);
     }
     
@@ -102,6 +234,9 @@ void setup() {
     analogSetAttenuation(ADC_11db);
     ledcSetup(0, 20000, 8);  // 20kHz PWM, 8-bit resolution
     ledcAttachPin(PWM_PIN, 0);
+
+    cellScanner.begin();
+    cellScanner.startScan();
     
     // Initialize UI
     if (!ui.begin()) {
@@ -179,6 +314,11 @@ void updateCharging() {
         batteryVoltage = readBatteryVoltage();
         chargeCurrent = readChargeCurrent();
         temperature = getBatteryTemperature();
+
+        // Take the pass started last tick, then start the next one
+        float cells[CELL_COUNT];
+        bool haveCells = cellScanner.read(cells);
+        cellScanner.startScan();
         
         // Update voltage history every second
         static unsigned long lastVoltageUpdate = 0;
@@ -193,6 +333,10 @@ void updateCharging() {
             case CHARGING:
                 // Check for termination conditions
                 if(temperature > 45.0f) {
+                    errorText = "Error - Overtemp";
+                    chargerState = ERROR;
+                    stopCharging();
+                } else if(haveCells && !cellsHealthy(cells, currentTime - chargeStartTime)) {
                     chargerState = ERROR;
                     stopCharging();
                 } else if(detectMinusAV()) {
@@ -224,6 +368,9 @@ void updateCharging() {
         }
         
         // Update UI widgets
+        if(haveCells) {
+            ((BatteryWidget*)mainScreen->getWidget(1))->setCellVoltages(cells);
+        }
         ((BatteryWidget*)mainScreen->getWidget(1))->updateValues(batteryVoltage, chargeCurrent);
         ((FloatDisplay*)mainScreen->getWidget(2))->setValue(temperature);
         ((FloatDisplay*)mainScreen->getWidget(3))->setValue(capacityMah);
@@ -255,6 +402,22 @@ bool detectMinusAV() {
     return (maxVoltage - currentVoltage) > (0.005f * CELL_COUNT);
 }
 
+// A cell that runs away high has stopped taking charge; one still low
+// after the first minute is shorted or dead. Sets errorText on failure.
+bool cellsHealthy(const float cells[CELL_COUNT], unsigned long chargingMs) {
+    for(int i = 0; i < CELL_COUNT; i++) {
+        if(cells[i] > CELL_VOLTAGE_ABORT) {
+            errorText = "Error - Cell high";
+            return false;
+        }
+        if(chargingMs >= CELL_CHECK_DELAY_MS && cells[i] < CELL_VOLTAGE_MIN) {
+            errorText = "Error - Weak cell";
+            return false;
+        }
+    }
+    return true;
+}
+
 float getBatteryTemperature() {
     // Using NTC thermistor
     const float BETA = 3950.0f;
@@ -274,7 +437,7 @@ const char* getStateString() {
         case CHARGING: return "Fast Charging";
         case TRICKLE: return "Trickle Charging";
         case COMPLETE: return "Charge Complete";
-        case ERROR: return "Error - Overtemp";
+        case ERROR: return errorText;
         default: return "Unknown State";
     }
 }
@@ -51,6 +51,12 @@ public:
     virtual void handleInput(const InputEvent& event) = 0;
     virtual void update() = 0;
     
+    // Incremental widgets repaint only what changed since their last draw;
+    // the others get their rect cleared first
+    virtual bool drawsIncrementally() const { return false; }
+    virtual void invalidate() { dirty = true; }
+    void clear(Adafruit_SSD1306& display) { display.fillRect(x, y, width, height, BLACK); }
+    
     void setFocus(bool focus) { focused = focus; dirty = true; }
     bool isFocused() const { return focused; }
     bool isDirty() const { return dirty; }
@@ -105,6 +111,9 @@ public:
     void draw(Adafruit_SSD1306& display) {
         for (auto widget : widgets) {
             if (widget->isDirty()) {
+                if (!widget->drawsIncrementally()) {
+                    widget->clear(display);
+                }
                 widget->draw(display);
                 widget->clearDirty();
             }
@@ -194,26 +203,43 @@ public:
 };
 
 // Progress Bar widget
+// Remembers the fill width on screen and only paints the columns that
+// grew or shrank since the last draw.
 class ProgressBar : public Widget {
 private:
     uint8_t progress;
     uint8_t maxValue;
+    int16_t shownFill;    // -1 until the outline has been drawn
+    
+    int16_t fillWidth() const { return (width - 4) * progress / maxValue; }
     
 public:
     ProgressBar(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t maxValue = 100)
-        : Widget(x, y, w, h), progress(0), maxValue(maxValue) {}
+        : Widget(x, y, w, h), progress(0), maxValue(maxValue), shownFill(-1) {}
     
     void setProgress(uint8_t value) {
         if (value != progress && value <= maxValue) {
             progress = value;
-            dirty = true;
+            if (fillWidth() != shownFill) dirty = true;
         }
     }
     
+    bool drawsIncrementally() const override { return true; }
+    void invalidate() override { shownFill = -1; dirty = true; }
+    
     void draw(Adafruit_SSD1306& display) override {
-        display.drawRect(x, y, width, height, WHITE);
-        uint16_t fillWidth = (width - 4) * progress / maxValue;
-        display.fillRect(x + 2, y + 2, fillWidth, height - 4, WHITE);
+        int16_t fill = fillWidth();
+        
+        if (shownFill < 0) {
+            clear(display);
+            display.drawRect(x, y, width, height, WHITE);
+            display.fillRect(x + 2, y + 2, fill, height - 4, WHITE);
+        } else if (fill > shownFill) {
+            display.fillRect(x + 2 + shownFill, y + 2, fill - shownFill, height - 4, WHITE);
+        } else if (fill < shownFill) {
+            display.fillRect(x + 2 + fill, y + 2, shownFill - fill, height - 4, BLACK);
+        }
+        shownFill = fill;
     }
     
     void handleInput(const InputEvent& event) override {}
@@ -280,8 +306,7 @@ public:
         currentScreen->handleInput(event);
         currentScreen->update();
         
-        // Redraw if needed
-        display.clearDisplay();
+        // Redraw what changed; the frame is only wiped in setScreen()
         currentScreen->draw(display);
         display.display();
     }
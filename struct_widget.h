@@ -0,0 +1,48 @@
+// struct_widget.h
+// Plain-struct widgets with function-pointer callbacks and a typed
+// per-instance context, for the sketches that don't use WidgetManager
+
+#ifndef STRUCT_WIDGET_H
+#define STRUCT_WIDGET_H
+
+#include <stdint.h>
+
+// Callback function types for widgets; each gets the widget it runs for
+struct Widget;
+typedef void (*ProcessCallback)(Widget &);
+typedef void (*DisplayCallback)(Widget &);
+
+// Define the Widget structure
+struct Widget {
+  int16_t x, y, width, height;  // Position and size
+  ProcessCallback processCb;    // Process callback (logic)
+  DisplayCallback displayCb;    // Display callback (rendering)
+  uint16_t processFrequency;    // Frequency for process update
+  uint32_t lastProcessTime;     // Last time process callback ran
+  bool hasFrame;                // Whether to draw a frame
+  bool hasBackground;           // Whether to fill a background
+  uint16_t bgColor;             // Background color
+  void *context;                // Per-instance data, of the type its callbacks take
+};
+
+// Callbacks are written against their context type; these adapt them to
+// the struct's untyped slot, so a widget can only be built with a context
+// its callbacks accept
+template <typename T, void (*Process)(T &)>
+void processTrampoline(Widget &widget) {
+  Process(*static_cast<T *>(widget.context));
+}
+
+template <typename T, void (*Display)(const Widget &, T &)>
+void displayTrampoline(Widget &widget) {
+  Display(widget, *static_cast<T *>(widget.context));
+}
+
+template <typename T, void (*Process)(T &), void (*Display)(const Widget &, T &)>
+Widget makeWidget(T &context, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t frequency,
+                  bool hasFrame, bool hasBackground, uint16_t bgColor) {
+  return { x, y, w, h, processTrampoline<T, Process>, displayTrampoline<T, Display>,
+           frequency, 0, hasFrame, hasBackground, bgColor, &context };
+}
+
+#endif // STRUCT_WIDGET_H
@@ -1,13 +1,21 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_ILI9341.h>
 #include <SPI.h>
+#include <vector>
 #include "color_theme.h"  // Added color theme header
+#include "layout_playlist.h"
 
 // TFT pins
 #define TFT_CS     15
 #define TFT_DC     2
 #define TFT_RST    4
 
+#define PANEL_ROTATION 3   // Fixed mount; set once via the controller's MADCTL
+
+// Screen size after rotation
+#define SCREEN_W ((PANEL_ROTATION & 1) ? ILI9341_TFTHEIGHT : ILI9341_TFTWIDTH)
+#define SCREEN_H ((PANEL_ROTATION & 1) ? ILI9341_TFTWIDTH : ILI9341_TFTHEIGHT)
+
 // Abstract Display Interface
 class Display {
 public:
@@ -21,6 +29,7 @@ public:
     virtual void print(float value, int decimals) = 0;
     virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
     virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) = 0;
+    virtual void drawRGBBitmap(int16_t x, int16_t y, uint16_t* pixels, int16_t w, int16_t h) = 0;
 };
 
 // Adafruit GFX Wrapper Implementation
@@ -70,6 +79,31 @@ public:
     void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
         tft.fillRect(x, y, w, h, color);
     }
+
+    void drawRGBBitmap(int16_t x, int16_t y, uint16_t* pixels, int16_t w, int16_t h) override {
+        tft.drawRGBBitmap(x, y, pixels, w, h);  // One address window, bulk pixel write
+    }
+};
+
+// Display over any GFX target; used to draw widgets off screen
+class CanvasDisplay : public Display {
+private:
+    Adafruit_GFX& gfx;
+
+public:
+    CanvasDisplay(Adafruit_GFX& _gfx) : gfx(_gfx) {}
+
+    void begin() override {}
+    void setRotation(uint8_t rotation) override {}
+    void fillScreen(uint16_t color) override { gfx.fillScreen(color); }
+    void setCursor(int16_t x, int16_t y) override { gfx.setCursor(x, y); }
+    void setTextColor(uint16_t color) override { gfx.setTextColor(color); }
+    void setTextSize(uint8_t size) override { gfx.setTextSize(size); }
+    void print(const char* text) override { gfx.print(text); }
+    void print(float value, int decimals) override { gfx.print(value, decimals); }
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override { gfx.drawPixel(x, y, color); }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override { gfx.fillRect(x, y, w, h, color); }
+    void drawRGBBitmap(int16_t x, int16_t y, uint16_t* pixels, int16_t w, int16_t h) override { gfx.drawRGBBitmap(x, y, pixels, w, h); }
 };
 
 // Abstract base class for widgets
@@ -93,6 +127,12 @@ public:
 
     virtual void displayWidget() = 0;
 
+    // Called when the widget's area has been wiped (e.g. on layout switch)
+    virtual void invalidate() {}
+
+    Display* getDisplay() const { return display; }
+    void setDisplay(Display* _display) { display = _display; }
+
 protected:
     virtual void processLogic() = 0;
 };
@@ -190,6 +230,303 @@ protected:
     }
 };
 
+// Large seven-segment numeric readout.
+// Segment rectangles are computed once for the widget's size, and each
+// update only repaints the segments that changed, so a full-screen value
+// costs a handful of fillRect calls instead of scaled font rendering.
+class SegmentDisplay : public Widget {
+private:
+    static const uint8_t MAX_DIGITS = 8;
+    static const uint8_t SEG_DP = 0x80;
+    static const uint8_t SEG_MINUS = 0x40;
+
+    struct SegmentRect {
+        int16_t x, y, w, h;
+    };
+
+    std::function<float()> dataSource;
+    uint8_t digits;
+    uint8_t decimals;
+    int16_t digitPitch;
+    SegmentRect segments[8];        // a-g and decimal point, relative to a digit
+    uint8_t target[MAX_DIGITS];     // Segment masks for the latest value
+    uint8_t shown[MAX_DIGITS];      // Segment masks currently on screen
+    bool onScreen;
+
+    // Segment masks for 0-9, bit order gfedcba
+    static uint8_t digitMask(uint8_t d) {
+        static const uint8_t masks[10] = { 0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F };
+        return masks[d];
+    }
+
+    void computeGeometry() {
+        // Each digit is h/2 wide plus a gap of two stroke widths
+        int16_t h = min<int16_t>(height, width * 10 / (digits * 7));
+        int16_t t = max<int16_t>(2, h / 10);
+        int16_t w = h / 2;
+        int16_t gy = h / 2 - t / 2;       // top of the middle bar
+        int16_t upperH = gy - t;
+        int16_t lowerY = gy + t;
+        int16_t lowerH = h - t - lowerY;
+
+        segments[0] = { t, 0, (int16_t)(w - 2 * t), t };              // a
+        segments[1] = { (int16_t)(w - t), t, t, upperH };             // b
+        segments[2] = { (int16_t)(w - t), lowerY, t, lowerH };        // c
+        segments[3] = { t, (int16_t)(h - t), (int16_t)(w - 2 * t), t }; // d
+        segments[4] = { 0, lowerY, t, lowerH };                       // e
+        segments[5] = { 0, t, t, upperH };                            // f
+        segments[6] = { t, gy, (int16_t)(w - 2 * t), t };             // g
+        segments[7] = { (int16_t)(w + t / 2), (int16_t)(h - t), t, t }; // dp
+        digitPitch = w + 2 * t;
+    }
+
+public:
+    SegmentDisplay(Display* _display, int16_t _x, int16_t _y, int16_t _w, int16_t _h, uint16_t _processFrequency,
+                   std::function<float()> _dataSource, uint8_t _digits, uint8_t _decimals = 0)
+        : Widget(_display, _x, _y, _w, _h, _processFrequency), dataSource(_dataSource),
+          digits(min<uint8_t>(_digits, MAX_DIGITS)), decimals(_decimals), onScreen(false) {
+        computeGeometry();
+        memset(target, 0, sizeof(target));
+        memset(shown, 0, sizeof(shown));
+    }
+
+    void invalidate() override {
+        onScreen = false;
+    }
+
+    void displayWidget() override {
+        if (!onScreen) {
+            display->fillRect(x, y, width, height, COLOR_WIDGET_BG);
+            memset(shown, 0, sizeof(shown));
+            onScreen = true;
+        }
+
+        for (uint8_t i = 0; i < digits; i++) {
+            uint8_t changed = shown[i] ^ target[i];
+            for (uint8_t s = 0; changed; s++, changed >>= 1) {
+                if (!(changed & 1)) continue;
+                const SegmentRect& r = segments[s];
+                uint16_t color = (target[i] & (1 << s)) ? COLOR_TEXT : COLOR_WIDGET_BG;
+                display->fillRect(x + i * digitPitch + r.x, y + r.y, r.w, r.h, color);
+            }
+            shown[i] = target[i];
+        }
+    }
+
+protected:
+    void processLogic() override {
+        float value = dataSource();
+        bool negative = value < 0;
+        long scaled = lroundf(fabsf(value) * powf(10, decimals));
+
+        // Right-aligned digits, at least one before the decimal point
+        memset(target, 0, sizeof(target));
+        int8_t pos = digits - 1;
+        do {
+            target[pos] = digitMask(scaled % 10);
+            scaled /= 10;
+            pos--;
+        } while (pos >= 0 && (scaled > 0 || pos >= digits - 1 - decimals));
+
+        if (negative && pos >= 0) {
+            target[pos] = SEG_MINUS;
+        } else if (scaled > 0 || negative) {
+            // Doesn't fit: show dashes rather than a truncated number
+            memset(target, SEG_MINUS, digits);
+            return;
+        }
+
+        if (decimals > 0 && decimals < digits) {
+            target[digits - 1 - decimals] |= SEG_DP;
+        }
+    }
+};
+
+// Colour-coded grid of values, e.g. one cell per charging bay or cell.
+// Values are quantized to LUT_SIZE buckets; the bucket colours are blended
+// once from the theme's low/normal/high value colours, and a cell is only
+// repainted when its bucket changes, so noisy but stable readings cost
+// nothing on the bus.
+class HeatmapWidget : public Widget {
+private:
+    static const uint8_t LUT_SIZE = 32;
+    static const uint8_t UNKNOWN = 0xFF;
+    static const int16_t GAP = 2;   // Background between cells
+
+    const float* values;            // rows * cols, row-major
+    uint8_t rows, cols;
+    float minValue, bucketScale;
+    std::vector<uint8_t> target;    // Latest bucket per cell
+    std::vector<uint8_t> shown;     // Bucket on screen, UNKNOWN after a wipe
+    bool backgroundShown;
+
+    // Shared colour table, low -> normal -> high
+    static const uint16_t* lut() {
+        static uint16_t table[LUT_SIZE];
+        static bool built = false;
+        if (!built) {
+            const uint8_t half = LUT_SIZE / 2;
+            for (uint8_t i = 0; i < LUT_SIZE; i++) {
+                table[i] = i < half ? blend565(COLOR_VALUE_LOW, COLOR_VALUE_NORMAL, i * 256 / half)
+                                    : blend565(COLOR_VALUE_NORMAL, COLOR_VALUE_HIGH, (i - half) * 256 / (LUT_SIZE - 1 - half));
+            }
+            built = true;
+        }
+        return table;
+    }
+
+    // Linear blend of two RGB565 colours, t in 0..256
+    static uint16_t blend565(uint16_t a, uint16_t b, uint16_t t) {
+        int16_t r = (a >> 11) + (((int16_t)(b >> 11) - (a >> 11)) * t >> 8);
+        int16_t g = ((a >> 5) & 0x3F) + (((int16_t)((b >> 5) & 0x3F) - ((a >> 5) & 0x3F)) * t >> 8);
+        int16_t bl = (a & 0x1F) + (((int16_t)(b & 0x1F) - (a & 0x1F)) * t >> 8);
+        return (r << 11) | (g << 5) | bl;
+    }
+
+public:
+    HeatmapWidget(Display* _display, int16_t _x, int16_t _y, int16_t _w, int16_t _h, uint16_t _processFrequency,
+                  const float* _values, uint8_t _rows, uint8_t _cols, float _minValue, float _maxValue)
+        : Widget(_display, _x, _y, _w, _h, _processFrequency), values(_values), rows(_rows), cols(_cols),
+          minValue(_minValue), bucketScale((LUT_SIZE - 1) / (_maxValue - _minValue)),
+          target(_rows * _cols, 0), shown(_rows * _cols, UNKNOWN), backgroundShown(false) {}
+
+    void invalidate() override {
+        std::fill(shown.begin(), shown.end(), UNKNOWN);
+        backgroundShown = false;
+    }
+
+    void displayWidget() override {
+        const uint16_t* colors = lut();
+        if (!backgroundShown) {
+            display->fillRect(x, y, width, height, COLOR_WIDGET_BG);
+            backgroundShown = true;
+        }
+
+        for (uint8_t r = 0; r < rows; r++) {
+            int16_t top = y + r * height / rows;
+            int16_t bottom = y + (r + 1) * height / rows;
+            for (uint8_t c = 0; c < cols; c++) {
+                uint16_t i = r * cols + c;
+                if (target[i] == shown[i]) continue;
+                int16_t left = x + c * width / cols;
+                int16_t right = x + (c + 1) * width / cols;
+                display->fillRect(left + GAP, top + GAP, right - left - 2 * GAP, bottom - top - 2 * GAP, colors[target[i]]);
+                shown[i] = target[i];
+            }
+        }
+    }
+
+protected:
+    void processLogic() override {
+        for (uint16_t i = 0; i < target.size(); i++) {
+            float bucket = (values[i] - minValue) * bucketScale + 0.5f;
+            target[i] = bucket <= 0 ? 0 : bucket >= LUT_SIZE - 1 ? LUT_SIZE - 1 : (uint8_t)bucket;
+        }
+    }
+};
+
+// Distribution of a value over a sliding time window (e.g. watts over
+// the last hour). The window is split into time slices that keep their
+// own bucket counts: adding a sample is two increments, and a whole slice
+// expires at once by subtracting its counts, so no sample is ever
+// rescanned and samples can come in at any rate. Bars are redrawn only
+// when their height in pixels changes, and then only the difference.
+class HistogramWidget : public Widget {
+private:
+    static const uint8_t SLICES = 60;
+
+    std::function<float()> dataSource;
+    uint8_t buckets;
+    float minValue, bucketScale;
+    uint32_t sliceMs;
+    uint8_t currentSlice;
+    uint32_t sliceStart;
+    std::vector<uint32_t> sliceCounts;   // SLICES * buckets
+    std::vector<uint32_t> counts;        // Sum over all slices
+    uint32_t total;
+    std::vector<int16_t> shownHeight;    // -1 when the bar isn't on screen
+    bool backgroundShown;
+
+    // Drops the slices that have fallen out of the window
+    void advanceTo(uint32_t now) {
+        uint8_t steps = 0;
+        while (now - sliceStart >= sliceMs && steps++ < SLICES) {
+            sliceStart += sliceMs;
+            currentSlice = (currentSlice + 1) % SLICES;
+            uint32_t* expired = &sliceCounts[currentSlice * buckets];
+            for (uint8_t b = 0; b < buckets; b++) {
+                counts[b] -= expired[b];
+                total -= expired[b];
+                expired[b] = 0;
+            }
+        }
+        if (now - sliceStart >= sliceMs) {
+            sliceStart = now;   // Idle for longer than the window: everything expired above
+        }
+    }
+
+    uint16_t barColor(uint8_t b) const {
+        return b >= buckets * 4 / 5 ? COLOR_GRAPH_HIGHLIGHT : COLOR_GRAPH;
+    }
+
+public:
+    HistogramWidget(Display* _display, int16_t _x, int16_t _y, int16_t _w, int16_t _h, uint16_t _processFrequency,
+                    std::function<float()> _dataSource, float _minValue, float _maxValue,
+                    uint8_t _buckets = 16, uint32_t windowMs = 3600000UL)
+        : Widget(_display, _x, _y, _w, _h, _processFrequency), dataSource(_dataSource), buckets(_buckets),
+          minValue(_minValue), bucketScale(_buckets / (_maxValue - _minValue)), sliceMs(windowMs / SLICES),
+          currentSlice(0), sliceStart(0), sliceCounts(SLICES * _buckets, 0), counts(_buckets, 0), total(0),
+          shownHeight(_buckets, -1), backgroundShown(false) {}
+
+    // Can be fed directly from a fast sampling loop
+    void addSample(float value) {
+        advanceTo(millis());
+        float scaled = (value - minValue) * bucketScale;
+        uint8_t b = scaled <= 0 ? 0 : scaled >= buckets ? buckets - 1 : (uint8_t)scaled;
+        sliceCounts[currentSlice * buckets + b]++;
+        counts[b]++;
+        total++;
+    }
+
+    // Share of the window spent in bucket b
+    float fraction(uint8_t b) const { return total ? (float)counts[b] / total : 0; }
+
+    void invalidate() override {
+        std::fill(shownHeight.begin(), shownHeight.end(), -1);
+        backgroundShown = false;
+    }
+
+    void displayWidget() override {
+        if (!backgroundShown) {
+            display->fillRect(x, y, width, height, COLOR_WIDGET_BG);
+            display->fillRect(x, y + height - 1, width, 1, COLOR_GRAPH_AXIS);
+            backgroundShown = true;
+        }
+
+        int16_t maxBar = height - 1;
+        for (uint8_t b = 0; b < buckets; b++) {
+            int16_t h = total ? (int16_t)((uint64_t)counts[b] * maxBar / total) : 0;
+            int16_t shown = max<int16_t>(shownHeight[b], 0);
+            if (h == shownHeight[b]) continue;
+
+            int16_t left = x + b * width / buckets;
+            int16_t barW = x + (b + 1) * width / buckets - left - 1;
+            int16_t base = y + maxBar;
+            if (h > shown) {
+                display->fillRect(left, base - h, barW, h - shown, barColor(b));
+            } else if (h < shown) {
+                display->fillRect(left, base - shown, barW, shown - h, COLOR_WIDGET_BG);
+            }
+            shownHeight[b] = h;
+        }
+    }
+
+protected:
+    void processLogic() override {
+        addSample(dataSource());
+    }
+};
+
 // WidgetManager implementation remains the same
 class WidgetManager {
 private:
@@ -197,6 +534,7 @@ private:
     int totalWidgetCount;
     Widget **currentLayout;
     int currentLayoutSize;
+    PrerenderedFrame prerender { SCREEN_W, SCREEN_H };
 
 public:
     WidgetManager(Widget **_allWidgets, int _totalWidgetCount) 
@@ -205,7 +543,57 @@ public:
     void switchLayout(Widget **newLayout, int newSize) {
         currentLayout = newLayout;
         currentLayoutSize = newSize;
-        allWidgets[0]->display->fillScreen(COLOR_BG);  // Use themed background color
+        if (currentLayoutSize > 0 && currentLayout[0]) {
+            currentLayout[0]->getDisplay()->fillScreen(COLOR_BG);  // Use themed background color
+        }
+        for (int i = 0; i < currentLayoutSize; i++) {
+            currentLayout[i]->invalidate();
+        }
+    }
+
+    // Steps through the playlist. During the last PRERENDER_LEAD_MS of a
+    // layout the next one is drawn off screen, one band per call, and when
+    // it is due it is sent with bulk transfers instead of blanking the
+    // screen and drawing widget by widget.
+    void runPlaylist(LayoutPlaylist<Widget>& playlist, uint32_t currentTime) {
+        if (playlist.advance(currentTime)) {
+            const LayoutPlaylist<Widget>::Entry& entry = playlist.current();
+            if (prerender.isComplete() && entry.count > 0) {
+                currentLayout = entry.widgets;
+                currentLayoutSize = entry.count;
+                Display* screen = currentLayout[0]->getDisplay();
+                prerender.present([screen](int16_t y, uint16_t* pixels, int16_t w, int16_t h) {
+                    screen->drawRGBBitmap(0, y, pixels, w, h);
+                });
+                // Values may have moved on while the bands were rendered, so
+                // stateful widgets resync on their next draw
+                for (int i = 0; i < currentLayoutSize; i++) {
+                    currentLayout[i]->invalidate();
+                }
+            } else {
+                prerender.discard();
+                switchLayout(entry.widgets, entry.count);
+            }
+            return;
+        }
+
+        if (!prerender.available() || playlist.msUntilSwitch(currentTime) > PRERENDER_LEAD_MS) return;
+
+        if (!prerender.isStarted()) {
+            const LayoutPlaylist<Widget>::Entry& next = playlist.upcoming();
+            prerender.start(COLOR_BG, [next](Adafruit_GFX& canvas) {
+                CanvasDisplay offscreen(canvas);
+                for (int i = 0; i < next.count; i++) {
+                    Widget* widget = next.widgets[i];
+                    Display* live = widget->getDisplay();
+                    widget->setDisplay(&offscreen);
+                    widget->invalidate();
+                    widget->displayWidget();
+                    widget->setDisplay(live);
+                }
+            });
+        }
+        prerender.renderStep();
     }
 
     void processAllWidgets(uint32_t currentTime) {
@@ -225,6 +613,10 @@ public:
 float watts = 0, volts = 0, amperes = 0, wattHours = 0;
 uint32_t lastWhCalculationTime = 0;
 
+// Per-bay temperatures (simulated), 2 rows of 4 bays
+const uint8_t BAY_ROWS = 2, BAY_COLS = 4;
+float bayTemperatures[BAY_ROWS * BAY_COLS];
+
 // Functions to compute dynamic data
 float getWatts() { return watts; }
 float getVolts() { return volts; }
@@ -239,22 +631,39 @@ void updateWattHours() {
     lastWhCalculationTime = currentTime;
 }
 
+// Random walk standing in for the bay temperature sensors
+void updateBayTemperatures() {
+    static uint32_t lastUpdate = 0;
+    if (millis() - lastUpdate < 500) return;
+    lastUpdate = millis();
+
+    for (uint8_t i = 0; i < BAY_ROWS * BAY_COLS; i++) {
+        bayTemperatures[i] = constrain(bayTemperatures[i] + random(-10, 11) / 100.0f, 20.0f, 60.0f);
+    }
+}
+
 // Widget Definitions
-Display* display;
+AdafruitDisplay tftDisplay(TFT_CS, TFT_DC, TFT_RST);
+Display* display = &tftDisplay;
 TextWidget wattsWidget(display, 10, 10, 100, 30, 100, "Watts", getWatts);
 TextWidget voltsWidget(display, 10, 40, 100, 30, 1000, "Volts", getVolts);
 TextWidget amperesWidget(display, 10, 70, 100, 30, 1000, "Amperes", getAmperes);
 GraphWidget wattsGraphWidget(display, 10, 100, 220, 50, 1000, getWatts);
 TextWidget wattHoursWidget(display, 10, 10, 100, 30, 1000, "Watt Hours", getWattHours);
 GraphWidget wattHoursGraphWidget(display, 10, 100, 220, 50, 1000, getWattHours);
+SegmentDisplay bigWattsWidget(display, 10, 40, 300, 120, 250, getWatts, 5, 1);
+HistogramWidget wattsHistogramWidget(display, 10, 110, 300, 120, 100, getWatts, 0, 500);
+HeatmapWidget bayHeatmapWidget(display, 10, 50, 300, 180, 200, bayTemperatures, BAY_ROWS, BAY_COLS, 20.0f, 60.0f);
 
 // Widget arrays for different layouts
 Widget* layout1[] = { &wattsWidget, &voltsWidget, &wattsGraphWidget };
-Widget* layout2[] = { &wattsWidget, &voltsWidget, &amperesWidget };
+Widget* layout2[] = { &wattsWidget, &voltsWidget, &amperesWidget, &wattsHistogramWidget };
 Widget* layout3[] = { &wattsWidget, &wattHoursWidget, &wattHoursGraphWidget };
+Widget* layout4[] = { &bigWattsWidget };  // Readable from across the room
+Widget* layout5[] = { &wattsWidget, &bayHeatmapWidget };
 
 // All widgets list
-Widget* allWidgets[] = { &wattsWidget, &voltsWidget, &amperesWidget, &wattsGraphWidget, &wattHoursWidget, &wattHoursGraphWidget };
+Widget* allWidgets[] = { &wattsWidget, &voltsWidget, &amperesWidget, &wattsGraphWidget, &wattHoursWidget, &wattHoursGraphWidget, &bigWattsWidget, &bayHeatmapWidget, &wattsHistogramWidget };
 
 // Total widget count
 int totalWidgetCount = sizeof(allWidgets) / sizeof(allWidgets[0]);
@@ -262,14 +671,26 @@ int totalWidgetCount = sizeof(allWidgets) / sizeof(allWidgets[0]);
 // Initialize WidgetManager
 WidgetManager manager(allWidgets, totalWidgetCount);
 
+// Layout rotation (can also be driven by buttons or conditions)
+LayoutPlaylist<Widget> playlist;
+
 void setup() {
     // Initialize the display
-    display = new AdafruitDisplay(TFT_CS, TFT_DC, TFT_RST);
     display->begin();
-    display->setRotation(3);
+    display->setRotation(PANEL_ROTATION);
     display->fillScreen(COLOR_BG);  // Use themed background color
 
     lastWhCalculationTime = millis();
+    for (uint8_t i = 0; i < BAY_ROWS * BAY_COLS; i++) {
+        bayTemperatures[i] = 25.0f;
+    }
+
+    playlist.add(layout1, sizeof(layout1) / sizeof(layout1[0]), 20000);
+    playlist.add(layout2, sizeof(layout2) / sizeof(layout2[0]), 20000);
+    playlist.add(layout3, sizeof(layout3) / sizeof(layout3[0]), 20000);
+    playlist.add(layout4, sizeof(layout4) / sizeof(layout4[0]), 20000);
+    playlist.add(layout5, sizeof(layout5) / sizeof(layout5[0]), 20000);
+    playlist.begin(millis());
 
     // Initial layout
     manager.switchLayout(layout1, sizeof(layout1) / sizeof(layout1[0]));
@@ -286,13 +707,8 @@ void loop() {
 
     // Update watt-hours integration in background
     updateWattHours();
+    updateBayTemperatures();
 
-    // Example layout switching (can be triggered by buttons or conditions)
-    if (currentTime > 20000 && currentTime < 40000) {
-        manager.switchLayout(layout2, sizeof(layout2) / sizeof(layout2[0]));
-    } else if (currentTime > 40000 && currentTime < 60000) {
-        manager.switchLayout(layout3, sizeof(layout3) / sizeof(layout3[0]));
-    } else if (currentTime > 60000) {
-        manager.switchLayout(layout1, sizeof(layout1) / sizeof(layout1[0]));
-    }
+    // Switch layouts on schedule, pre-rendering the next one in the meantime
+    manager.runPlaylist(playlist, currentTime);
 }
@@ -1,6 +1,7 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_ILI9341.h>  // Example: For TFT display
 #include <SPI.h>
+#include "struct_widget.h"
 
 #define TFT_CS     15
 #define TFT_RST    4
@@ -13,89 +14,81 @@ const uint16_t COLOR_TEXT = ILI9341_WHITE;
 const uint16_t COLOR_FRAME = ILI9341_BLUE;
 const uint16_t COLOR_GRAPH = ILI9341_GREEN;
 
-// Callback function types for widgets
-typedef void (*ProcessCallback)(void *);
-typedef void (*DisplayCallback)(void *);
-
-// Define the Widget structure
-struct Widget {
-  int16_t x, y, width, height;  // Position and size
-  ProcessCallback processCb;    // Process callback (logic)
-  DisplayCallback displayCb;    // Display callback (rendering)
-  uint16_t processFrequency;    // Frequency for process update
-  uint32_t lastProcessTime;     // Last time process callback ran
-  bool hasFrame;                // Whether to draw a frame
-  bool hasBackground;           // Whether to fill a background
-  uint16_t bgColor;             // Background color
-};
+#define HISTORY_LEN 50
 
-// Dynamic data variables
-float watts = 0, volts = 0, amperes = 0;
-float wattsHistory[50]; // Rolling history for graph
-int historyIndex = 0;
+// Readings of one supply, shared by every widget that shows it
+struct Supply {
+  float watts, volts, amperes;
+  float wattsHistory[HISTORY_LEN];  // Rolling history for graph
+  int historyIndex;
+};
 
 // Process Callbacks
-void processWatts(void *data) {
-  watts = volts * amperes;  // Compute watts
+void processWatts(Supply &supply) {
+  supply.watts = supply.volts * supply.amperes;  // Compute watts
 }
 
-void processVolts(void *data) {
-  volts = random(220, 230); // Simulate voltage readings (220-230V)
+void processVolts(Supply &supply) {
+  supply.volts = random(220, 230); // Simulate voltage readings (220-230V)
 }
 
-void processAmperes(void *data) {
-  amperes = random(1, 5);   // Simulate amperage readings (1-5A)
+void processAmperes(Supply &supply) {
+  supply.amperes = random(1, 5);   // Simulate amperage readings (1-5A)
 }
 
-void updateWattsGraph(void *data) {
-  wattsHistory[historyIndex] = watts;
-  historyIndex = (historyIndex + 1) % 50;  // Circular buffer for history
+void updateWattsGraph(Supply &supply) {
+  supply.wattsHistory[supply.historyIndex] = supply.watts;
+  supply.historyIndex = (supply.historyIndex + 1) % HISTORY_LEN;  // Circular buffer for history
 }
 
 // Display Callbacks
-void displayWatts(void *data) {
-  tft.setCursor(10, 10);
+void displayReading(const Widget &widget, const char *label, float value) {
+  tft.setCursor(widget.x, widget.y);
   tft.setTextColor(COLOR_TEXT);
   tft.setTextSize(2);
-  tft.print("Watts: ");
-  tft.println(watts);
+  tft.print(label);
+  tft.println(value);
 }
 
-void displayVolts(void *data) {
-  tft.setCursor(10, 40);
-  tft.setTextColor(COLOR_TEXT);
-  tft.setTextSize(2);
-  tft.print("Volts: ");
-  tft.println(volts);
+void displayWatts(const Widget &widget, Supply &supply) {
+  displayReading(widget, "Watts: ", supply.watts);
 }
 
-void displayAmperes(void *data) {
-  tft.setCursor(10, 70);
-  tft.setTextColor(COLOR_TEXT);
-  tft.setTextSize(2);
-  tft.print("Amperes: ");
-  tft.println(amperes);
+void displayVolts(const Widget &widget, Supply &supply) {
+  displayReading(widget, "Volts: ", supply.volts);
+}
+
+void displayAmperes(const Widget &widget, Supply &supply) {
+  displayReading(widget, "Amperes: ", supply.amperes);
 }
 
-void displayWattsGraph(void *data) {
-  tft.fillRect(10, 100, 220, 50, COLOR_BG);  // Clear graph area
-  for (int i = 0; i < 50; i++) {
-    int index = (historyIndex + i) % 50;
-    int graphX = 10 + i * 4;
-    int graphY = 150 - wattsHistory[index] * 10; // Scale watts to graph
+void displayWattsGraph(const Widget &widget, Supply &supply) {
+  tft.fillRect(widget.x, widget.y, widget.width, widget.height, COLOR_BG);  // Clear graph area
+  for (int i = 0; i < HISTORY_LEN; i++) {
+    int index = (supply.historyIndex + i) % HISTORY_LEN;
+    int graphX = widget.x + i * 4;
+    int graphY = widget.y + widget.height - supply.wattsHistory[index] * 10; // Scale watts to graph
     tft.drawPixel(graphX, graphY, COLOR_GRAPH);
   }
 }
 
+// Two supplies, the second listed under the first; their contexts sit
+// together in one array, so widgets of the same type walk contiguous memory
+#define SUPPLIES 2
+Supply supplies[SUPPLIES];
+
 // Define Widgets
-Widget wattsWidget = {10, 10, 100, 30, processWatts, displayWatts, 100, 0, true, false, COLOR_BG};
-Widget voltsWidget = {10, 40, 100, 30, processVolts, displayVolts, 1000, 0, true, false, COLOR_BG};
-Widget amperesWidget = {10, 70, 100, 30, processAmperes, displayAmperes, 1000, 0, true, false, COLOR_BG};
-Widget wattsGraphWidget = {10, 100, 220, 50, updateWattsGraph, displayWattsGraph, 1000, 0, true, false, COLOR_BG};
+Widget wattsWidget = makeWidget<Supply, processWatts, displayWatts>(supplies[0], 10, 10, 220, 30, 100, true, false, COLOR_BG);
+Widget voltsWidget = makeWidget<Supply, processVolts, displayVolts>(supplies[0], 10, 40, 220, 30, 1000, true, false, COLOR_BG);
+Widget amperesWidget = makeWidget<Supply, processAmperes, displayAmperes>(supplies[0], 10, 70, 220, 30, 1000, true, false, COLOR_BG);
+Widget wattsGraphWidget = makeWidget<Supply, updateWattsGraph, displayWattsGraph>(supplies[0], 10, 100, 220, 50, 1000, true, false, COLOR_BG);
+Widget wattsWidget2 = makeWidget<Supply, processWatts, displayWatts>(supplies[1], 10, 160, 220, 30, 100, true, false, COLOR_BG);
+Widget voltsWidget2 = makeWidget<Supply, processVolts, displayVolts>(supplies[1], 10, 190, 220, 30, 1000, true, false, COLOR_BG);
+Widget amperesWidget2 = makeWidget<Supply, processAmperes, displayAmperes>(supplies[1], 10, 220, 220, 30, 1000, true, false, COLOR_BG);
 
 // Layouts
 Widget *layout1[] = { &wattsWidget, &voltsWidget, &wattsGraphWidget };
-Widget *layout2[] = { &wattsWidget, &voltsWidget, &amperesWidget };
+Widget *layout2[] = { &wattsWidget, &voltsWidget, &amperesWidget, &wattsWidget2, &voltsWidget2, &amperesWidget2 };
 Widget *layout3[] = { &voltsWidget, &wattsGraphWidget };
 Widget *layout4[] = { &wattsWidget };
 
@@ -121,9 +114,10 @@ void setup() {
   tft.fillScreen(COLOR_BG);
   
   // Set initial data
-  wattsWidget.processCb(&watts);
-  voltsWidget.processCb(&volts);
-  amperesWidget.processCb(&amperes);
+  Widget *readings[] = { &voltsWidget, &amperesWidget, &wattsWidget, &voltsWidget2, &amperesWidget2, &wattsWidget2 };
+  for (Widget *widget : readings) {
+    widget->processCb(*widget);
+  }
 }
 
 void loop() {
@@ -135,12 +129,12 @@ void loop() {
     
     // Process logic based on frequency
     if (currentTime - widget->lastProcessTime >= widget->processFrequency) {
-      widget->processCb(&watts);  // Update the relevant data
+      widget->processCb(*widget);  // Update the widget's own data
       widget->lastProcessTime = currentTime;
     }
 
     // Call the display callback to render the widget
-    widget->displayCb(&watts);
+    widget->displayCb(*widget);
     
     // Draw a frame around the widget if enabled
     if (widget->hasFrame) {
@@ -1,12 +1,30 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_ILI9341.h>
 #include <SPI.h>
+#include <vector>
+#include <algorithm>
+#include "layout_playlist.h"
+#include "channel_meter.h"
+#include "widget_manager.h"
 
 #define TFT_CS     15
 #define TFT_RST    4
 #define TFT_DC     2
+
+// Panel mounting orientation. The ILI9341 applies it in hardware (MADCTL),
+// so it is written once at init and never touches the drawing path.
+#define PANEL_ROTATION 3
+
+// Screen size after rotation
+#define SCREEN_W ((PANEL_ROTATION & 1) ? ILI9341_TFTHEIGHT : ILI9341_TFTWIDTH)
+#define SCREEN_H ((PANEL_ROTATION & 1) ? ILI9341_TFTWIDTH : ILI9341_TFTHEIGHT)
+
 Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);
 
+// Target of all widget drawing. Normally the TFT; points at an off-screen
+// band while the next layout is being pre-rendered.
+Adafruit_GFX *gfx = &tft;
+
 // Define color scheme
 const uint16_t COLOR_BG = ILI9341_BLACK;
 const uint16_t COLOR_TEXT = ILI9341_WHITE;
@@ -17,173 +35,173 @@ const uint16_t COLOR_GRAPH = ILI9341_GREEN;
 #define CREATE_WIDGET(_x, _y, _w, _h, _processCb, _displayCb, _frequency) \
   Widget(_x, _y, _w, _h, _processCb, _displayCb, _frequency)
 
-// Widget class representing a single widget
-class Widget {
-  public:
-    int16_t x, y, width, height;
-    std::function<void()> processCb;  // Lambda for process callback
-    std::function<void()> displayCb;  // Lambda for display callback
-    uint16_t processFrequency;
-    uint32_t lastProcessTime;
-    bool hasFrame;
-    bool hasBackground;
-    uint16_t bgColor;
-
-    Widget(int16_t _x, int16_t _y, int16_t _w, int16_t _h,
-           std::function<void()> _processCb, std::function<void()> _displayCb, uint16_t _frequency)
-      : x(_x), y(_y), width(_w), height(_h),
-        processCb(_processCb), displayCb(_displayCb),
-        processFrequency(_frequency), lastProcessTime(0),
-        hasFrame(true), hasBackground(false), bgColor(COLOR_BG) {}
-
-    void process(uint32_t currentTime) {
-      if (currentTime - lastProcessTime >= processFrequency) {
-        processCb();
-        lastProcessTime = currentTime;
-      }
-    }
+// Circuits metered by this unit (8-16 per board)
+#define METER_CHANNELS 8
 
-    void display() {
-      if (hasBackground) {
-        tft.fillRect(x, y, width, height, bgColor);
-      }
-      displayCb();
-      if (hasFrame) {
-        tft.drawRect(x, y, width, height, COLOR_FRAME);
-      }
-    }
-};
+// Each metering window is one mains cycle of samples
+#define SAMPLES_PER_CYCLE 40
+#define METER_WINDOW_MS 100
 
-// WidgetManager class to handle layout switching and updates
-class WidgetManager {
-  public:
-    WidgetManager(Widget **_allWidgets, int _totalWidgetCount, Widget **layout, int layoutSize) 
-      : allWidgets(_allWidgets), totalWidgetCount(_totalWidgetCount),
-        currentLayout(layout), currentLayoutSize(layoutSize) {}
-
-    // Switches the layout but keeps processing all widgets in the background
-    void switchLayout(Widget **newLayout, int newSize) {
-      currentLayout = newLayout;
-      currentLayoutSize = newSize;
-      tft.fillScreen(COLOR_BG);  // Clear the screen when switching layouts
-    }
+#define HISTORY_LEN 50
 
-    // Process all widgets (even if not part of the current layout)
-    void processAllWidgets(uint32_t currentTime) {
-      for (int i = 0; i < totalWidgetCount; i++) {
-        allWidgets[i]->process(currentTime);
-      }
-    }
+ChannelMeter<METER_CHANNELS> meter;
 
-    // Update display only for widgets in the current layout
-    void updateDisplay() {
-      for (int i = 0; i < currentLayoutSize; i++) {
-        currentLayout[i]->display();
-      }
-    }
+// Circuit shown by the single-circuit layouts; moves on each time the
+// overview comes round
+uint8_t detailChannel = 0;
 
-  private:
-    Widget **allWidgets;
-    int totalWidgetCount;
-    Widget **currentLayout;
-    int currentLayoutSize;
-};
+// Rolling histories for the graphs, one row per channel
+float wattsHistory[METER_CHANNELS][HISTORY_LEN];
+float wattHoursHistory[METER_CHANNELS][HISTORY_LEN];
+int wattsHistoryIndex = 0;
+int wattHoursHistoryIndex = 0;
 
-// Dynamic data for widgets
-float watts = 0, volts = 0, amperes = 0;
-float wattsHistory[50];     // Rolling history for watts graph
-float wattHours = 0;        // Accumulated watt-hours
-float wattHoursHistory[50]; // Rolling history for watt-hours graph
-int historyIndex = 0;
+// One sample batch: the shared voltage, then a row of current per channel
+float voltageSamples[SAMPLES_PER_CYCLE];
+float currentSamples[METER_CHANNELS * SAMPLES_PER_CYCLE];
+uint32_t lastWindowTime = 0;
 
-// Time tracking for Wh integration (milliseconds to hours conversion)
-uint32_t lastWhCalculationTime = 0;
-const float MS_TO_HOURS = 1.0 / (60 * 60 * 1000);  // Milliseconds to hours conversion factor
+// Simulated loads: RMS current and phase lag of each circuit
+float loadAmps[METER_CHANNELS];
+float loadPhase[METER_CHANNELS];
+float sineTable[SAMPLES_PER_CYCLE], cosineTable[SAMPLES_PER_CYCLE];
 
-// Process functions using lambdas
-auto processWatts = []() { watts = volts * amperes; };
-auto processVolts = []() { volts = random(220, 230); };
-auto processAmperes = []() { amperes = random(1, 5); };
+void initSimulation() {
+  for (int k = 0; k < SAMPLES_PER_CYCLE; k++) {
+    sineTable[k] = sinf(2 * PI * k / SAMPLES_PER_CYCLE);
+    cosineTable[k] = cosf(2 * PI * k / SAMPLES_PER_CYCLE);
+  }
+  for (int c = 0; c < METER_CHANNELS; c++) {
+    loadAmps[c] = random(1, 5);
+    loadPhase[c] = random(0, 40) * (PI / 180);
+  }
+}
 
-// Watt-hours calculation
-auto processWattHours = []() {
-  uint32_t currentTime = millis();
-  float deltaTime = (currentTime - lastWhCalculationTime) * MS_TO_HOURS;  // Convert time to hours
-  wattHours += watts * deltaTime;   // Integrate watts over time to get watt-hours
-  lastWhCalculationTime = currentTime;  // Update the last calculation time
-};
+// Stands in for the ADC: one mains cycle of voltage and per-circuit current
+void sampleCircuits() {
+  float voltsPeak = random(220, 230) * M_SQRT2;
+  for (int k = 0; k < SAMPLES_PER_CYCLE; k++) {
+    voltageSamples[k] = voltsPeak * sineTable[k];
+  }
+  for (int c = 0; c < METER_CHANNELS; c++) {
+    if (random(100) == 0) loadAmps[c] = random(1, 5);  // Loads switch now and then
+    float ampsPeak = loadAmps[c] * M_SQRT2;
+    float s = ampsPeak * cosf(loadPhase[c]), q = ampsPeak * sinf(loadPhase[c]);
+    float *row = currentSamples + c * SAMPLES_PER_CYCLE;
+    for (int k = 0; k < SAMPLES_PER_CYCLE; k++) {
+      row[k] = s * sineTable[k] - q * cosineTable[k];  // sin(wt - phase)
+    }
+  }
+}
+
+void updateMeter(uint32_t currentTime) {
+  if (currentTime - lastWindowTime < METER_WINDOW_MS) return;
+  sampleCircuits();
+  meter.addBatch(voltageSamples, currentSamples, SAMPLES_PER_CYCLE);
+  meter.closeWindow(currentTime - lastWindowTime);
+  lastWindowTime = currentTime;
+}
 
-// Update watts and watt-hours history for graph
+// Readings come from the meter; value widgets have nothing to compute
+auto noProcess = []() {};
+
+// Update watts and watt-hours history for graph, all channels at once
 auto updateWattsGraph = []() {
-  wattsHistory[historyIndex] = watts;
-  historyIndex = (historyIndex + 1) % 50;  // Circular buffer for history
+  for (int c = 0; c < METER_CHANNELS; c++) {
+    wattsHistory[c][wattsHistoryIndex] = meter.watts[c];
+  }
+  wattsHistoryIndex = (wattsHistoryIndex + 1) % HISTORY_LEN;  // Circular buffer for history
 };
 
 auto updateWattHoursGraph = []() {
-  wattHoursHistory[historyIndex] = wattHours;
-  historyIndex = (historyIndex + 1) % 50;  // Circular buffer for history
+  for (int c = 0; c < METER_CHANNELS; c++) {
+    wattHoursHistory[c][wattHoursHistoryIndex] = meter.wattHours[c];
+  }
+  wattHoursHistoryIndex = (wattHoursHistoryIndex + 1) % HISTORY_LEN;
 };
 
 // Display functions using lambdas
 auto displayWatts = []() {
-  tft.setCursor(10, 10);
-  tft.setTextColor(COLOR_TEXT);
-  tft.setTextSize(2);
-  tft.print("Watts: ");
-  tft.println(watts);
+  gfx->setCursor(10, 10);
+  gfx->setTextColor(COLOR_TEXT);
+  gfx->setTextSize(2);
+  gfx->print("Watts: ");
+  gfx->println(meter.watts[detailChannel]);
 };
 
 auto displayVolts = []() {
-  tft.setCursor(10, 40);
-  tft.setTextColor(COLOR_TEXT);
-  tft.setTextSize(2);
-  tft.print("Volts: ");
-  tft.println(volts);
+  gfx->setCursor(10, 40);
+  gfx->setTextColor(COLOR_TEXT);
+  gfx->setTextSize(2);
+  gfx->print("Volts: ");
+  gfx->println(meter.volts);
 };
 
 auto displayAmperes = []() {
-  tft.setCursor(10, 70);
-  tft.setTextColor(COLOR_TEXT);
-  tft.setTextSize(2);
-  tft.print("Amperes: ");
-  tft.println(amperes);
+  gfx->setCursor(10, 70);
+  gfx->setTextColor(COLOR_TEXT);
+  gfx->setTextSize(2);
+  gfx->print("Amperes: ");
+  gfx->println(meter.amps[detailChannel]);
 };
 
 auto displayWattsGraph = []() {
-  tft.fillRect(10, 100, 220, 50, COLOR_BG);  // Clear graph area
-  for (int i = 0; i < 50; i++) {
-    int index = (historyIndex + i) % 50;
+  gfx->fillRect(10, 100, 220, 50, COLOR_BG);  // Clear graph area
+  for (int i = 0; i < HISTORY_LEN; i++) {
+    int index = (wattsHistoryIndex + i) % HISTORY_LEN;
     int graphX = 10 + i * 4;
-    int graphY = 150 - wattsHistory[index] * 10;  // Scale watts to graph
-    tft.drawPixel(graphX, graphY, COLOR_GRAPH);
+    int graphY = 150 - wattsHistory[detailChannel][index] * 10;  // Scale watts to graph
+    gfx->drawPixel(graphX, graphY, COLOR_GRAPH);
   }
 };
 
 auto displayWattHours = []() {
-  tft.setCursor(10, 10);
-  tft.setTextColor(COLOR_TEXT);
-  tft.setTextSize(2);
-  tft.print("Watt-hours: ");
-  tft.println(wattHours, 2);  // Display with 2 decimal precision
+  gfx->setCursor(10, 10);
+  gfx->setTextColor(COLOR_TEXT);
+  gfx->setTextSize(2);
+  gfx->print("Watt-hours: ");
+  gfx->println(meter.wattHours[detailChannel], 2);  // Display with 2 decimal precision
 };
 
 auto displayWattHoursGraph = []() {
-  tft.fillRect(10, 100, 220, 50, COLOR_BG);  // Clear graph area
-  for (int i = 0; i < 50; i++) {
-    int index = (historyIndex + i) % 50;
+  gfx->fillRect(10, 100, 220, 50, COLOR_BG);  // Clear graph area
+  for (int i = 0; i < HISTORY_LEN; i++) {
+    int index = (wattHoursHistoryIndex + i) % HISTORY_LEN;
     int graphX = 10 + i * 4;
-    int graphY = 150 - wattHoursHistory[index] * 10;  // Scale watt-hours to graph
-    tft.drawPixel(graphX, graphY, COLOR_GRAPH);
+    int graphY = 150 - wattHoursHistory[detailChannel][index] * 10;  // Scale watt-hours to graph
+    gfx->drawPixel(graphX, graphY, COLOR_GRAPH);
   }
 };
 
+// One overview tile per circuit, two columns. Text is drawn with an
+// opaque background at fixed width, so no clearing is needed.
+Widget *makeChannelTile(uint8_t channel) {
+  const int16_t tileW = SCREEN_W / 2;
+  const int16_t tileH = SCREEN_H / ((METER_CHANNELS + 1) / 2);
+  int16_t x = (channel % 2) * tileW, y = (channel / 2) * tileH;
+
+  return new Widget(x, y, tileW, tileH, noProcess, [channel, x, y]() {
+    char line[32];
+    gfx->setTextColor(COLOR_TEXT, COLOR_BG);
+    gfx->setTextSize(1);
+    snprintf(line, sizeof(line), "CH%-2d %6.0f W %5.1f A", channel + 1,
+             meter.watts[channel], meter.amps[channel]);
+    gfx->setCursor(x + 4, y + 4);
+    gfx->print(line);
+    snprintf(line, sizeof(line), "     %8.2f Wh", meter.wattHours[channel]);
+    gfx->setCursor(x + 4, y + 16);
+    gfx->print(line);
+  }, 1000);
+}
+
 // Define Widgets
-Widget wattsWidget = CREATE_WIDGET(10, 10, 100, 30, processWatts, displayWatts, 100);
-Widget voltsWidget = CREATE_WIDGET(10, 40, 100, 30, processVolts, displayVolts, 1000);
-Widget amperesWidget = CREATE_WIDGET(10, 70, 100, 30, processAmperes, displayAmperes, 1000);
-Widget wattsGraphWidget = CREATE_WIDGET(10, 100, 220, 50, updateWattsGraph, displayWattsGraph, 1000);
-Widget wattHoursWidget = CREATE_WIDGET(10, 10, 100, 30, processWattHours, displayWattHours, 1000);
-Widget wattHoursGraphWidget = CREATE_WIDGET(10, 100, 220, 50, updateWattHoursGraph, displayWattHoursGraph, 1000);
+Widget wattsWidget = CREATE_WIDGET(10, 10, 100, 30, noProcess, displayWatts, 100);
+Widget voltsWidget = CREATE_WIDGET(10, 40, 100, 30, noProcess, displayVolts, 1000);
+Widget amperesWidget = CREATE_WIDGET(10, 70, 100, 30, noProcess, displayAmperes, 1000);
+// The graphs clear their whole area before plotting, so they are opaque
+Widget wattsGraphWidget = CREATE_WIDGET(10, 100, 220, 50, updateWattsGraph, displayWattsGraph, 1000).setOpaque(true);
+Widget wattHoursWidget = CREATE_WIDGET(10, 10, 100, 30, noProcess, displayWattHours, 1000);
+Widget wattHoursGraphWidget = CREATE_WIDGET(10, 100, 220, 50, updateWattHoursGraph, displayWattHoursGraph, 1000).setOpaque(true);
 
 // Layouts
 Widget *layout1[] = { &wattsWidget, &voltsWidget, &wattsGraphWidget };
@@ -195,6 +213,9 @@ Widget *layout4[] = { &wattsWidget };
 // Layout 5 displays watt-hours and its graph
 Widget *layout5[] = { &wattHoursWidget, &wattHoursGraphWidget };
 
+// Layout 6 is the all-circuit overview, filled in by setup()
+Widget *layout6[METER_CHANNELS];
+
 // Total widget list for background processing
 Widget *allWidgets[] = { &wattsWidget, &voltsWidget, &amperesWidget, &wattsGraphWidget, &wattHoursWidget, &wattHoursGraphWidget };
 
@@ -204,37 +225,56 @@ int layout2Size = sizeof(layout2) / sizeof(layout2[0]);
 int layout3Size = sizeof(layout3) / sizeof(layout3[0]);
 int layout4Size = sizeof(layout4) / sizeof(layout4[0]);
 int layout5Size = sizeof(layout5) / sizeof(layout5[0]);
+int layout6Size = METER_CHANNELS;
 int allWidgetsSize = sizeof(allWidgets) / sizeof(allWidgets[0]);
 
 // Initialize widget manager with all widgets and initial layout
-WidgetManager manager(allWidgets, allWidgetsSize, layout1, layout1Size);
+WidgetManager<Adafruit_ILI9341, SCREEN_W, SCREEN_H> manager(tft, allWidgets, allWidgetsSize, layout1, layout1Size);
+
+// Layout rotation, 20 seconds each
+LayoutPlaylist<Widget> playlist;
 
 void setup() {
   tft.begin();
-  tft.setRotation(3);  // Adjust screen orientation if necessary
+  tft.setRotation(PANEL_ROTATION);
   tft.fillScreen(COLOR_BG);
 
-  // Initialize lastWhCalculationTime to current time
-  lastWhCalculationTime = millis();
+  for (uint8_t c = 0; c < METER_CHANNELS; c++) {
+    layout6[c] = makeChannelTile(c);
+  }
+  initSimulation();
+
+  playlist.add(layout1, layout1Size, 20000);
+  playlist.add(layout2, layout2Size, 20000);
+  playlist.add(layout3, layout3Size, 20000);
+  playlist.add(layout4, layout4Size, 20000);
+  playlist.add(layout5, layout5Size, 20000);
+  playlist.add(layout6, layout6Size, 20000);
+  playlist.begin(millis());
+
+  lastWindowTime = millis();
 }
 
 void loop() {
   uint32_t currentTime = millis();
 
+  // Close a metering window for every circuit
+  updateMeter(currentTime);
+
   // Process all widgets, even if they are not part of the current layout
   manager.processAllWidgets(currentTime);
 
   // Update only the widgets in the current layout for display
   manager.updateDisplay();
 
-  // Example layout switching based on time (or add your own conditions)
-  if (currentTime > 20000 && currentTime < 40000) {
-    manager.switchLayout(layout2, layout2Size);  // Switch to layout 2
-  } else if (currentTime > 40000 && currentTime < 60000) {
-    manager.switchLayout(layout3, layout3Size);  // Switch to layout 3
-  } else if (currentTime > 60000 && currentTime < 80000) {
-    manager.switchLayout(layout4, layout4Size);  // Switch to layout 4
-  } else if (currentTime > 80000) {
-    manager.switchLayout(layout5, layout5Size);  // Switch to watt-hours layout
+  // Switch layouts on schedule, pre-rendering the next one in the meantime
+  manager.runPlaylist(playlist, currentTime);
+
+  // Tour the circuits: the detail layouts after the overview show the next
+  // one (switched here so the pre-render of layout 1 already uses it)
+  static Widget **shownLayout = nullptr;
+  if (playlist.current().widgets != shownLayout) {
+    shownLayout = playlist.current().widgets;
+    if (shownLayout == layout6) detailChannel = (detailChannel + 1) % METER_CHANNELS;
   }
 }
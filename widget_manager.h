@@ -0,0 +1,241 @@
+// widget_manager.h
+// Widgets with process and display callbacks, and the manager that runs
+// them through layouts
+
+#ifndef WIDGET_MANAGER_H
+#define WIDGET_MANAGER_H
+
+#include <Adafruit_GFX.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "layout_playlist.h"
+
+// Provided by the sketch: where widgets draw (the panel, or an off-screen
+// band while a layout is pre-rendered), and the colour scheme. Host builds
+// may render several UIs on worker threads, so there each thread has its
+// own target.
+#ifdef ARDUINO
+extern Adafruit_GFX *gfx;
+#else
+extern thread_local Adafruit_GFX *gfx;
+#endif
+extern const uint16_t COLOR_BG;
+extern const uint16_t COLOR_FRAME;
+
+// Screen rectangle used for occlusion and clipping
+struct Rect {
+  int16_t x, y, w, h;
+
+  bool contains(const Rect &r) const {
+    return r.x >= x && r.y >= y && r.x + r.w <= x + w && r.y + r.h <= y + h;
+  }
+
+  Rect intersect(const Rect &r) const {
+    int16_t x0 = max(x, r.x), y0 = max(y, r.y);
+    int16_t x1 = min(x + w, r.x + r.w), y1 = min(y + h, r.y + r.h);
+    return { x0, y0, (int16_t)max(0, x1 - x0), (int16_t)max(0, y1 - y0) };
+  }
+
+  bool empty() const { return w <= 0 || h <= 0; }
+};
+
+// Widget class representing a single widget
+class Widget {
+  public:
+    int16_t x, y, width, height;
+    std::function<void()> processCb;  // Lambda for process callback
+    std::function<void()> displayCb;  // Lambda for display callback
+    uint16_t processFrequency;
+    uint32_t lastProcessTime;
+    bool hasFrame;
+    bool hasBackground;
+    uint16_t bgColor;
+    uint8_t zOrder;   // Higher values are drawn on top
+    bool opaque;      // Paints every pixel of its rect, hiding what is below
+
+    Widget(int16_t _x, int16_t _y, int16_t _w, int16_t _h,
+           std::function<void()> _processCb, std::function<void()> _displayCb, uint16_t _frequency)
+      : x(_x), y(_y), width(_w), height(_h),
+        processCb(_processCb), displayCb(_displayCb),
+        processFrequency(_frequency), lastProcessTime(0),
+        hasFrame(true), hasBackground(false), bgColor(COLOR_BG),
+        zOrder(0), opaque(false) {}
+
+    Widget &setZOrder(uint8_t z) { zOrder = z; return *this; }
+    Widget &setOpaque(bool value) { opaque = value; return *this; }
+
+    Rect bounds() const { return { x, y, width, height }; }
+
+    void process(uint32_t currentTime) {
+      if (currentTime - lastProcessTime >= processFrequency) {
+        processCb();
+        lastProcessTime = currentTime;
+      }
+    }
+
+    // Draws the widget; background and frame are limited to the visible
+    // part of the widget when something opaque covers one of its edges.
+    void display(const Rect &visible) {
+      if (hasBackground) {
+        gfx->fillRect(visible.x, visible.y, visible.w, visible.h, bgColor);
+      }
+      displayCb();
+      if (hasFrame) {
+        drawFrame(visible);
+      }
+    }
+
+  private:
+    void drawFrame(const Rect &visible) {
+      if (visible.contains(bounds())) {
+        gfx->drawRect(x, y, width, height, COLOR_FRAME);
+        return;
+      }
+      Rect edges[] = {
+        { x, y, width, 1 }, { x, (int16_t)(y + height - 1), width, 1 },
+        { x, y, 1, height }, { (int16_t)(x + width - 1), y, 1, height }
+      };
+      for (const Rect &edge : edges) {
+        Rect part = edge.intersect(visible);
+        if (!part.empty()) {
+          gfx->fillRect(part.x, part.y, part.w, part.h, COLOR_FRAME);
+        }
+      }
+    }
+};
+
+// WidgetManager class to handle layout switching and updates. Panel is
+// the display class, so its own bulk drawRGBBitmap() is the one used;
+// the screen size is the one after rotation.
+template <typename Panel, int16_t SCREEN_WIDTH, int16_t SCREEN_HEIGHT>
+class WidgetManager {
+  public:
+    WidgetManager(Panel &_panel, Widget **_allWidgets, int _totalWidgetCount, Widget **layout, int layoutSize)
+      : panel(_panel), allWidgets(_allWidgets), totalWidgetCount(_totalWidgetCount),
+        currentLayout(layout), currentLayoutSize(layoutSize) {
+      buildDrawList();
+    }
+
+    // Switches the layout but keeps processing all widgets in the background
+    void switchLayout(Widget **newLayout, int newSize) {
+      currentLayout = newLayout;
+      currentLayoutSize = newSize;
+      buildDrawList();
+      panel.fillScreen(COLOR_BG);  // Clear the screen when switching layouts
+    }
+
+    // Steps through the playlist. The upcoming layout is pre-rendered off
+    // screen, one band per call, during the last PRERENDER_LEAD_MS of the
+    // current one; when it is due it goes out as a few bulk transfers
+    // instead of a blank screen followed by widget-by-widget drawing.
+    void runPlaylist(LayoutPlaylist<Widget> &playlist, uint32_t currentTime) {
+      if (playlist.advance(currentTime)) {
+        const LayoutPlaylist<Widget>::Entry &entry = playlist.current();
+        if (prerender.isComplete()) {
+          currentLayout = entry.widgets;
+          currentLayoutSize = entry.count;
+          buildDrawList();
+          prerender.present([this](int16_t y, uint16_t *pixels, int16_t w, int16_t h) {
+            panel.drawRGBBitmap(0, y, pixels, w, h);
+          });
+        } else {
+          prerender.discard();
+          switchLayout(entry.widgets, entry.count);
+        }
+        return;
+      }
+
+      if (!prerender.available() || playlist.msUntilSwitch(currentTime) > PRERENDER_LEAD_MS) return;
+
+      if (!prerender.isStarted()) {
+        const LayoutPlaylist<Widget>::Entry &next = playlist.upcoming();
+        prerender.start(COLOR_BG, [this, next](Adafruit_GFX &canvas) {
+          std::vector<DrawEntry> list;
+          buildDrawList(next.widgets, next.count, list);
+          gfx = &canvas;
+          for (const DrawEntry &entry : list) {
+            entry.widget->display(entry.visible);
+          }
+          gfx = &panel;
+        });
+      }
+      prerender.renderStep();
+    }
+
+    // Process all widgets (even if not part of the current layout)
+    void processAllWidgets(uint32_t currentTime) {
+      for (int i = 0; i < totalWidgetCount; i++) {
+        allWidgets[i]->process(currentTime);
+      }
+    }
+
+    // Update display only for the visible widgets of the current layout,
+    // bottom to top
+    void updateDisplay() {
+      for (const DrawEntry &entry : drawList) {
+        entry.widget->display(entry.visible);
+      }
+    }
+
+  private:
+    struct DrawEntry {
+      Widget *widget;
+      Rect visible;
+    };
+
+    Panel &panel;
+    Widget **allWidgets;
+    int totalWidgetCount;
+    Widget **currentLayout;
+    int currentLayoutSize;
+    std::vector<DrawEntry> drawList;
+    PrerenderedFrame prerender { SCREEN_WIDTH, SCREEN_HEIGHT };
+
+    void buildDrawList() {
+      buildDrawList(currentLayout, currentLayoutSize, drawList);
+    }
+
+    // Orders the layout by z and works out how much of each widget is left
+    // visible under the opaque widgets above it. Fully covered widgets are
+    // dropped; an occluder that covers a whole edge shrinks the visible
+    // rect. Holes in the middle can't be expressed as a rect, so those
+    // widgets keep their full rect and are simply painted over.
+    static void buildDrawList(Widget **layout, int layoutSize, std::vector<DrawEntry> &drawList) {
+      drawList.clear();
+      std::vector<Widget *> order(layout, layout + layoutSize);
+      std::stable_sort(order.begin(), order.end(), [](const Widget *a, const Widget *b) {
+        return a->zOrder < b->zOrder;
+      });
+
+      for (size_t i = 0; i < order.size(); i++) {
+        Rect visible = order[i]->bounds();
+
+        for (size_t j = i + 1; j < order.size() && !visible.empty(); j++) {
+          if (!order[j]->opaque) continue;
+          Rect cover = visible.intersect(order[j]->bounds());
+          if (cover.empty()) continue;
+
+          if (cover.w == visible.w && cover.h == visible.h) {
+            visible.w = visible.h = 0;
+          } else if (cover.w == visible.w && cover.y == visible.y) {
+            visible.y += cover.h;
+            visible.h -= cover.h;
+          } else if (cover.w == visible.w && cover.y + cover.h == visible.y + visible.h) {
+            visible.h -= cover.h;
+          } else if (cover.h == visible.h && cover.x == visible.x) {
+            visible.x += cover.w;
+            visible.w -= cover.w;
+          } else if (cover.h == visible.h && cover.x + cover.w == visible.x + visible.w) {
+            visible.w -= cover.w;
+          }
+        }
+
+        if (!visible.empty()) {
+          drawList.push_back({ order[i], visible });
+        }
+      }
+    }
+};
+
+#endif // WIDGET_MANAGER_H